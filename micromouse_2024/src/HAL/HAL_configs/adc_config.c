@@ -26,7 +26,9 @@
 /*----------------------------------------------------------------------------*/
 /*                                Definitions                                 */
 /*----------------------------------------------------------------------------*/
-/* None */
+#if CONFIG_ADC_SAMPLE_BITS != (MM_ADC_RESOLUTION_BITS + MM_ADC_OVERSAMPLE_BITS)
+#error "CONFIG_ADC_SAMPLE_BITS does not match the ADC resolution + oversampling"
+#endif
 
 /*----------------------------------------------------------------------------*/
 /*                               Debug Switches                               */
@@ -43,6 +45,10 @@ static adc_handler_t adcInterfaceHandler =
     .adc_EnableChannel = at32uc3l0256_EnableAdcChannel,
     .adc_DisableChannel = at32uc3l0256_DisableAdcChannel,
     .adc_ReadValue = at32uc3l0256_ReadValue,
+    .adc_StartSampling = at32uc3l0256_StartAdcSampling,
+    .adc_StopSampling = at32uc3l0256_StopAdcSampling,
+    .adc_ReadSamples = at32uc3l0256_ReadAdcSamples,
+    .adc_SetScanHandler = at32uc3l0256_SetAdcScanHandler,
 };
 
 /*----------------------------------------------------------------------------*/
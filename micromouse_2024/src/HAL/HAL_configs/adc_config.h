@@ -21,7 +21,9 @@
 /*----------------------------------------------------------------------------*/
 /*                                Definitions                                 */
 /*----------------------------------------------------------------------------*/
-/* None */
+/* bits per value from adc_ReadSamples() on the linked hardware- checked */
+/* against the hardware's resolution and oversampling in adc_config.c */
+#define CONFIG_ADC_SAMPLE_BITS    (13u)
 
 /*----------------------------------------------------------------------------*/
 /*                              Global Variables                              */
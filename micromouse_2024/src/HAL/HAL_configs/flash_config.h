@@ -0,0 +1,36 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : flash_config.h
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-03-31
+* Purpose         : HAL config layer
+*
+* This file is the header file for the flash config file.
+*
+* HAL config files define handlers for high level code to access hardware
+* specific code abstracted out w/ HAL contracts. Bridges contracts and
+* hardware specific code by creating an instance of a contract w/ members
+* filled w/ hardware specific code that adheres to the contract.
+*
+* Step 2 for hardware abstraction.
+*-----------------------------------------------------------------------------*/
+
+#ifndef FLASH_CONFIG_H_
+#define FLASH_CONFIG_H_
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+void config_GetFlashHandler(flash_handler_t** p_flashHandler);
+
+#endif /* FLASH_CONFIG_H_ */
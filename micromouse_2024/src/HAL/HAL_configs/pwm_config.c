@@ -42,6 +42,7 @@ static pwm_handler_t pwmInterfaceHandler =
     .pwm_Init = at32uc3l0256_InitPwm,
     .pwm_SetWheelMotor1DutyCycle = at32uc3l0256_SetWheelMotor1DutyCycle,
     .pwm_SetWheelMotor2DutyCycle = at32uc3l0256_SetWheelMotor2DutyCycle,
+    .pwm_SetWheelMotorDutyCycles = at32uc3l0256_SetWheelMotorDutyCycles,
     .pwm_SetVacuumMotorDutyCycle = at32uc3l0256_SetVacuumMotorDutyCycle,
 };
 
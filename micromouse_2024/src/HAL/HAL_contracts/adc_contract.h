@@ -28,6 +28,10 @@ typedef enum
     ADC_READ_ERROR
 } adc_status_t;
 
+/* called from interrupt context w/ each complete scan before it is */
+/* published, values indexed by channel number may be changed in place */
+typedef void (*adc_scan_handler_t)(uint32_t* p_channelValues);
+
 /* ADC interface contract- used to create handlers */
 typedef struct
 {
@@ -36,6 +40,11 @@ typedef struct
     adc_status_t (*adc_DisableChannel)(const uint32_t channelAddress);
     adc_status_t (*adc_ReadValue)(
         const uint32_t channelAddress, uint32_t* p_readValue);
+    adc_status_t (*adc_StartSampling)(const uint32_t channelMask);
+    adc_status_t (*adc_StopSampling)(void);
+    adc_status_t (*adc_ReadSamples)(const uint32_t channelMask,
+        uint32_t* p_readValues, uint32_t* p_sequence);
+    adc_status_t (*adc_SetScanHandler)(adc_scan_handler_t scanHandler);
 } adc_handler_t;
 
 /*----------------------------------------------------------------------------*/
@@ -0,0 +1,49 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : flash_contract.h
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-03-31
+* Purpose         : HAL contract layer
+*
+* This file contains the contract to abstract a nonvolatile flash storage
+* interface.
+*
+* Contracts define features of interfaces so high level code can use abstract
+* handlers instead of hardware specific code. HAL config files use these
+* contracts to link to hardware specific code.
+*
+* Step 1 for hardware abstraction.
+*-----------------------------------------------------------------------------*/
+
+#ifndef FLASH_CONTRACT_H_
+#define FLASH_CONTRACT_H_
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+/* flash status enumeration */
+typedef enum
+{
+    FLASH_SUCCESS = 0u,
+    FLASH_ERROR
+} flash_status_t;
+
+/* flash interface contract- used to create handlers */
+typedef struct
+{
+    flash_status_t (*flash_Init)(void);
+    flash_status_t (*flash_Read)(void* p_data, uint32_t size);
+    flash_status_t (*flash_Write)(const void* p_data, uint32_t size);
+} flash_handler_t;
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+#endif /* FLASH_CONTRACT_H_ */
@@ -34,6 +34,8 @@ typedef struct
     pwm_status_t (*pwm_Init)(void);
     pwm_status_t (*pwm_SetWheelMotor1DutyCycle)(uint16_t dutyCycle);
     pwm_status_t (*pwm_SetWheelMotor2DutyCycle)(uint16_t dutyCycle);
+    pwm_status_t (*pwm_SetWheelMotorDutyCycles)(uint16_t motor1DutyCycle,
+        uint16_t motor2DutyCycle);
     pwm_status_t (*pwm_SetVacuumMotorDutyCycle)(uint16_t dutyCycle);
 } pwm_handler_t;
 
@@ -36,12 +36,87 @@
 /*----------------------------------------------------------------------------*/
 /*                              Global Variables                              */
 /*----------------------------------------------------------------------------*/
-/* None */
+/* background sampling- ISR fills one buffer while readers copy the other */
+static volatile uint32_t adcSampleBuffers[2][MM_ADC_CHANNEL_COUNT];
+static volatile uint32_t adcPublishedBuffer = 0u;
+static volatile uint32_t adcSampleSequence = 0u;
+static volatile uint32_t adcSampleMask = 0u;
+static volatile uint32_t adcScanReceived = 0u;
+static volatile uint32_t adcScanSums[MM_ADC_CHANNEL_COUNT];
+static volatile uint32_t adcScanCounts[MM_ADC_CHANNEL_COUNT];
+static volatile uint32_t adcScansSummed = 0u;
+static volatile adc_scan_handler_t adcScanHandler = NULL;
 
 /*----------------------------------------------------------------------------*/
 /*                    Private (Static) Function Prototype                     */
 /*----------------------------------------------------------------------------*/
-/* None */
+static uint32_t at32uc3l0256_PackAdcValues(const uint32_t channelMask,
+    const volatile uint32_t* p_channelValues, uint32_t* p_readValues);
+
+/*----------------------------------------------------------------------------*/
+/*                         Interrupt Service Routines                         */
+/*----------------------------------------------------------------------------*/
+/* ISR for ADCIFB data ready- one per channel in each triggered scan, so */
+/* 16 per published scan w/ 4 channels and 4x oversampling. At 2 kHz that */
+/* is about 32k interrupts per second */
+__attribute__((__interrupt__))
+static void adc_int_handler(void)
+{
+    uint32_t lastData = 0u;
+    uint32_t channel = 0u;
+    uint32_t backBuffer = adcPublishedBuffer ^ 1u;
+    uint32_t complete = 1u;
+    
+    /* reading the data register clears the data ready flag */
+    lastData = adcifb_get_last_data(&AVR32_ADCIFB);
+    channel = (lastData & AVR32_ADCIFB_LCDR_LCCH_MASK) >> 
+        AVR32_ADCIFB_LCDR_LCCH_OFFSET;
+    
+    if (channel < MM_ADC_CHANNEL_COUNT)
+    {
+        adcScanSums[channel] += lastData & MM_ADC_DATA_MASK;
+        adcScanCounts[channel]++;
+        adcScanReceived |= (1u << channel);
+    }
+    
+    /* whole scan in- keep summing until enough scans to decimate */
+    if ((adcScanReceived & adcSampleMask) == adcSampleMask)
+    {
+        adcScanReceived = 0u;
+        adcScansSummed++;
+    }
+    
+    /* decimate into the back buffer, publish it, fill the other one next */
+    if (adcScansSummed >= MM_ADC_OVERSAMPLE_SCANS)
+    {
+        adcScansSummed = 0u;
+        
+        /* a missed or late data ready leaves a channel w/ the wrong number */
+        /* of samples- its sum would decimate biased, so drop the whole set */
+        for (channel = 0u; channel < MM_ADC_CHANNEL_COUNT; channel++)
+        {
+            if ((adcSampleMask & (1u << channel)) && 
+                (adcScanCounts[channel] != MM_ADC_OVERSAMPLE_SCANS))
+                complete = 0u;
+        }
+        
+        for (channel = 0u; channel < MM_ADC_CHANNEL_COUNT; channel++)
+        {
+            adcSampleBuffers[backBuffer][channel] = 
+                adcScanSums[channel] >> MM_ADC_OVERSAMPLE_BITS;
+            adcScanSums[channel] = 0u;
+            adcScanCounts[channel] = 0u;
+        }
+        
+        if (complete)
+        {
+            if (adcScanHandler != NULL)
+                adcScanHandler((uint32_t*)adcSampleBuffers[backBuffer]);
+            adcPublishedBuffer = backBuffer;
+            adcSampleSequence++;
+        }
+    }
+}
 
 /*----------------------------------------------------------------------------*/
 /*                       Public (Exportable) Functions                        */
@@ -59,7 +134,7 @@ adc_status_t at32uc3l0256_InitAdc(void)
     const gpio_map_t ADCIFB_GPIO_MAP = MM_ADC_INIT_MAP;
     
     adcifb_opt_t adcifb_opt = {
-		.resolution = AVR32_ADCIFB_ACR_RES_10BIT, /* 10 or 12 bit ADC */
+		.resolution = MM_ADC_RESOLUTION, /* 10 or 12 bit ADC */
 		.shtim  = 15, /* Channels Sample & Hold Time in [0,15] */
 		.ratio_clkadcifb_clkadc =
 				(sysclk_get_pba_hz() / MM_ADC_CLK_FREQ_HZ),
@@ -162,13 +237,138 @@ adc_status_t at32uc3l0256_ReadValue(
 {
     adc_status_t adcStatus = ADC_ERROR;
     
-    *p_readValue = (uint32_t)(adcifb_get_last_data(&AVR32_ADCIFB) & 0xFFF);
+    *p_readValue = (uint32_t)(adcifb_get_last_data(&AVR32_ADCIFB) & 
+        MM_ADC_DATA_MASK);
     adcStatus = ADC_SUCCESS;
     
     /* return status */
     return adcStatus;
 }
 
+/**
+* Start sampling ADC channels in the background for AT32UC3L0256 MCU.
+*
+* The ADCIFB's periodic trigger starts a scan of all channels in the mask
+* and the data ready interrupt collects each result, so nothing waits on a
+* conversion. Global interrupts must be enabled for samples to arrive.
+* Published values are MM_ADC_OVERSAMPLE_SCANS scans decimated to
+* MM_ADC_RESOLUTION_BITS + MM_ADC_OVERSAMPLE_BITS bits. A set where any
+* channel missed a sample is dropped, the last published scan stays.
+*
+* \param[in] channelMask Channels to sample, bit n for channel n
+* \retval ADC_SUCCESS Success
+* \retval ADC_ERROR Failure: Failed to configure the trigger
+*/
+adc_status_t at32uc3l0256_StartAdcSampling(const uint32_t channelMask)
+{
+    adc_status_t adcStatus = ADC_SUCCESS;
+    uint32_t channel = 0u;
+    
+    adcSampleMask = channelMask;
+    adcScanReceived = 0u;
+    adcScansSummed = 0u;
+    adcSampleSequence = 0u;
+    for (channel = 0u; channel < MM_ADC_CHANNEL_COUNT; channel++)
+    {
+        adcScanSums[channel] = 0u;
+        adcScanCounts[channel] = 0u;
+    }
+    
+    INTC_register_interrupt(&adc_int_handler, MM_ADC_IRQ_LINE, 
+        MM_INTC_ADC_LEVEL);
+    
+    adcifb_channels_enable(&AVR32_ADCIFB, channelMask);
+    adcifb_enable_data_ready_interrupt(&AVR32_ADCIFB);
+    
+    if (adcifb_configure_trigger(&AVR32_ADCIFB, AVR32_ADCIFB_TRGMOD_PT, 
+        MM_ADC_TRIGGER_PERIOD) != PASS)
+        adcStatus = ADC_ERROR;
+    
+    /* return status */
+    return adcStatus;
+}
+
+/**
+* Stop background ADC sampling for AT32UC3L0256 MCU.
+*
+* Back to software triggered conversions- the last published samples stay
+* readable.
+*
+* \retval ADC_SUCCESS Success
+* \retval ADC_ERROR Failure: Failed to configure the trigger
+*/
+adc_status_t at32uc3l0256_StopAdcSampling(void)
+{
+    adc_status_t adcStatus = ADC_SUCCESS;
+    
+    if (adcifb_configure_trigger(&AVR32_ADCIFB, AVR32_ADCIFB_TRGMOD_NT, 0)
+        != PASS)
+        adcStatus = ADC_ERROR;
+    
+    adcifb_disable_data_ready_interrupt(&AVR32_ADCIFB);
+    adcifb_channels_disable(&AVR32_ADCIFB, adcSampleMask);
+    
+    /* return status */
+    return adcStatus;
+}
+
+/**
+* Read the latest background samples for AT32UC3L0256 MCU.
+*
+* Never waits on the ADC. The ISR only writes the buffer that is not
+* published, so a copy is consistent unless a whole new scan was published
+* during it- the sequence number catches that and the copy is retried.
+*
+* \param[in] channelMask Channels to read, must be sampled
+* \param[out] p_readValues One value per set bit, lowest channel first
+* \param[out] p_sequence Scan number of the values, 0 before the first scan
+* \retval ADC_SUCCESS Success
+* \retval ADC_READ_ERROR Failure: No scan yet, channel not sampled or torn
+*/
+adc_status_t at32uc3l0256_ReadAdcSamples(const uint32_t channelMask,
+    uint32_t* p_readValues, uint32_t* p_sequence)
+{
+    adc_status_t adcStatus = ADC_READ_ERROR;
+    uint32_t sequence = 0u;
+    uint32_t retry = 0u;
+    
+    if ((channelMask & adcSampleMask) != channelMask)
+        return ADC_READ_ERROR;
+    
+    for (retry = 0u; retry < MM_ADC_SAMPLE_RETRY_MAX; retry++)
+    {
+        sequence = adcSampleSequence;
+        at32uc3l0256_PackAdcValues(channelMask, 
+            adcSampleBuffers[adcPublishedBuffer], p_readValues);
+        
+        if (sequence == adcSampleSequence)
+        {
+            if (sequence != 0u)
+                adcStatus = ADC_SUCCESS;
+            break;
+        }
+    }
+    
+    *p_sequence = sequence;
+    
+    /* return status */
+    return adcStatus;
+}
+
+/**
+* Set the function run on each complete background scan for AT32UC3L0256 MCU.
+*
+* \param[in] scanHandler Function to run, NULL for none
+* \retval ADC_SUCCESS Success
+*/
+adc_status_t at32uc3l0256_SetAdcScanHandler(adc_scan_handler_t scanHandler)
+{
+    adcScanHandler = scanHandler;
+    
+    /* return status */
+    return ADC_SUCCESS;
+}
+
 /*----------------------------------------------------------------------------*/
 /*                           Local Shared Functions                           */
 /*----------------------------------------------------------------------------*/
@@ -177,4 +377,28 @@ adc_status_t at32uc3l0256_ReadValue(
 /*----------------------------------------------------------------------------*/
 /*                         Private (Static) Functions                         */
 /*----------------------------------------------------------------------------*/
-/* None */
+/**
+* Copy per channel values out in mask order, lowest channel first
+*
+* \param[in] channelMask Channels to copy, bit n for channel n
+* \param[in] p_channelValues Values indexed by channel number
+* \param[out] p_readValues One value per set bit
+* \retval number of values copied
+*/
+static uint32_t at32uc3l0256_PackAdcValues(const uint32_t channelMask,
+    const volatile uint32_t* p_channelValues, uint32_t* p_readValues)
+{
+    uint32_t index = 0u;
+    uint32_t channel = 0u;
+    
+    for (channel = 0u; channel < MM_ADC_CHANNEL_COUNT; channel++)
+    {
+        if (channelMask & (1u << channel))
+        {
+            p_readValues[index] = p_channelValues[channel];
+            index++;
+        }
+    }
+    
+    return index;
+}
@@ -47,7 +47,26 @@
 #define MM_ADC_INIT_DELAY_MS    (30u)          /* ADC init delay in ms */
 #define MM_ENABLE_DELAY_MS      (2u)           /* ADC enable delay in ms */
 #define MM_DISABLE_DELAY_MS     (0u)           /* ADC disable delay in ms */
-#define MM_ADC_WATCHDOG_MAX     (50000000u)    /* ADC watchdog counter max */
+#define MM_ADC_WATCHDOG_MAX     (5000u)        /* per conversion, ~100us */
+#define MM_ADC_CHANNEL_COUNT    (9u)           /* AD0 - AD8 */
+
+/* conversion resolution- RES_10BIT or RES_12BIT with matching bit count */
+#define MM_ADC_RESOLUTION       AVR32_ADCIFB_ACR_RES_12BIT
+#define MM_ADC_RESOLUTION_BITS  (12u)
+#define MM_ADC_DATA_MASK        ((1u << MM_ADC_RESOLUTION_BITS) - 1u)
+
+/* oversampling- 4^n scans summed and shifted down by n for n extra bits */
+/* (0 publishes every scan as is; published width is resolution + n) */
+#define MM_ADC_OVERSAMPLE_BITS  (1u)
+#define MM_ADC_OVERSAMPLE_SCANS (1u << (2u * MM_ADC_OVERSAMPLE_BITS))
+
+/* background sampling- periodic trigger from the ADCIFB's own timer */
+#define MM_ADC_SAMPLE_RATE_HZ   (2000u)        /* published scans per second */
+#define MM_ADC_TRIGGER_PERIOD   (MM_ADC_CLK_FREQ_HZ / \
+    (MM_ADC_SAMPLE_RATE_HZ * MM_ADC_OVERSAMPLE_SCANS))
+#define MM_ADC_IRQ_LINE         AVR32_ADCIFB_IRQ
+#define MM_INTC_ADC_LEVEL       AVR32_INTC_INT0    /* below the encoders */
+#define MM_ADC_SAMPLE_RETRY_MAX (4u)           /* reads torn by a new scan */
 
 /*----------------------------------------------------------------------------*/
 /*                              Global Variables                              */
@@ -62,5 +81,10 @@ adc_status_t at32uc3l0256_EnableAdcChannel(const uint32_t channelAddress);
 adc_status_t at32uc3l0256_DisableAdcChannel(const uint32_t channelAddress);
 adc_status_t at32uc3l0256_ReadValue(
     const uint32_t channelAddress, uint32_t* p_readValue);
+adc_status_t at32uc3l0256_StartAdcSampling(const uint32_t channelMask);
+adc_status_t at32uc3l0256_StopAdcSampling(void);
+adc_status_t at32uc3l0256_ReadAdcSamples(const uint32_t channelMask,
+    uint32_t* p_readValues, uint32_t* p_sequence);
+adc_status_t at32uc3l0256_SetAdcScanHandler(adc_scan_handler_t scanHandler);
 
 #endif /* ADC_AT32UC3L0256_H_ */
\ No newline at end of file
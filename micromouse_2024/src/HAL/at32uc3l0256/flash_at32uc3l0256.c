@@ -0,0 +1,128 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : flash_at32uc3l0256.c
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-03-31
+* Purpose         : hardware specific layer
+*
+* This file is the source file for hardware specific flash code.
+*
+* Step 3 for hardware abstraction.
+*
+* (if applicable)
+* Target Hardware    : AT32UC3L0256
+* IDE                : Atmel Studio 7.4.2542
+* SDK                : ASF 3.52.0
+*-----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <asf.h>
+#include <stdint.h>
+#include <string.h>
+#include "HAL/HAL_contracts/flash_contract.h"
+#include "HAL/at32uc3l0256/flash_at32uc3l0256.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                               Debug Switches                               */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                    Private (Static) Function Prototype                     */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+/**
+* Initialize flash interface for AT32UC3L0256 MCU.
+*
+* Flash wait states are already set up by the clock init, so this only
+* checks the flash controller is idle.
+*
+* \retval FLASH_SUCCESS Success
+* \retval FLASH_ERROR Failure: Controller is busy
+*/
+flash_status_t at32uc3l0256_InitFlash(void)
+{
+    flash_status_t flashStatus = FLASH_ERROR;
+    
+    if (flashcdw_is_ready())
+        flashStatus = FLASH_SUCCESS;
+    
+    /* return status */
+    return flashStatus;
+}
+
+/**
+* Read from flash storage area for AT32UC3L0256 MCU.
+*
+* \param[out] p_data Buffer to copy stored bytes into
+* \param[in] size Number of bytes to read
+* \retval FLASH_SUCCESS Success
+* \retval FLASH_ERROR Failure: Size larger than storage area
+*/
+flash_status_t at32uc3l0256_ReadFlash(void* p_data, uint32_t size)
+{
+    flash_status_t flashStatus = FLASH_ERROR;
+    
+    if (size <= MM_FLASH_STORAGE_SIZE)
+    {
+        memcpy(p_data, (const void*)MM_FLASH_STORAGE_ADDRESS, size);
+        flashStatus = FLASH_SUCCESS;
+    }
+    
+    /* return status */
+    return flashStatus;
+}
+
+/**
+* Write to flash storage area for AT32UC3L0256 MCU.
+*
+* Rest of the page, including the bootloader configuration, is kept.
+*
+* \param[in] p_data Bytes to store
+* \param[in] size Number of bytes to write
+* \retval FLASH_SUCCESS Success
+* \retval FLASH_ERROR Failure: Size too large, or lock/programming error
+*/
+flash_status_t at32uc3l0256_WriteFlash(const void* p_data, uint32_t size)
+{
+    flash_status_t flashStatus = FLASH_ERROR;
+    
+    if (size <= MM_FLASH_STORAGE_SIZE)
+    {
+        /* erase and rewrite the page w/ the new bytes in place */
+        flashcdw_memcpy((volatile void*)MM_FLASH_STORAGE_ADDRESS, p_data, 
+            size, true);
+        
+        if ((!flashcdw_is_lock_error()) && (!flashcdw_is_programming_error()))
+            flashStatus = FLASH_SUCCESS;
+    }
+    
+    /* return status */
+    return flashStatus;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                           Local Shared Functions                           */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                         Private (Static) Functions                         */
+/*----------------------------------------------------------------------------*/
+/* None */
@@ -0,0 +1,45 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : flash_at32uc3l0256.h
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-03-31
+* Purpose         : hardware specific layer
+*
+* This file is the header file for hardware specific flash code.
+*
+* Step 3 for hardware abstraction.
+*
+* TODO:
+*     - Add wear leveling if settings end up written often
+*
+*     Contract and config file simplified by tailoring hardware specific code
+*     to micromouse application. HAL not scalable to broader MCU use.
+*-----------------------------------------------------------------------------*/
+
+#ifndef FLASH_AT32UC3L0256_H_
+#define FLASH_AT32UC3L0256_H_
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+/* settings live at the start of the user page- survives chip erase/reflash */
+#define MM_FLASH_STORAGE_ADDRESS           (AVR32_FLASHCDW_USER_PAGE)
+
+/* last words of the user page hold the bootloader configuration */
+#define MM_FLASH_BOOTLOADER_RESERVED_BYTES (8u)
+#define MM_FLASH_STORAGE_SIZE \
+    (AVR32_FLASHCDW_USER_PAGE_SIZE - MM_FLASH_BOOTLOADER_RESERVED_BYTES)
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+flash_status_t at32uc3l0256_InitFlash(void);
+flash_status_t at32uc3l0256_ReadFlash(void* p_data, uint32_t size);
+flash_status_t at32uc3l0256_WriteFlash(const void* p_data, uint32_t size);
+
+#endif /* FLASH_AT32UC3L0256_H_ */
@@ -196,6 +196,53 @@ pwm_status_t at32uc3l0256_SetWheelMotor2DutyCycle(uint16_t dutyCycle)
     return pwmStatus;
 }
 
+/**
+* Set both wheel motor duty cycles in one PWMA write.
+* Skips the write if neither duty cycle changed.
+*
+* \param[in] motor1DutyCycle Duty cycle for wheel motor 1 (0~255)
+* \param[in] motor2DutyCycle Duty cycle for wheel motor 2 (0~255)
+* \retval   PWM_SUCCESS Success
+* \retval   PWM_ERROR Failure: invalid duty cycle or PWMA write failed
+*/
+pwm_status_t at32uc3l0256_SetWheelMotorDutyCycles(uint16_t motor1DutyCycle,
+    uint16_t motor2DutyCycle)
+{
+    pwm_status_t pwmStatus = PWM_ERROR;
+    
+    bool set_value_status = FAIL;
+    
+    /* check for valid duty cycles */
+    if ((motor1DutyCycle > MM_PWMA_TOP) || (motor2DutyCycle > MM_PWMA_TOP))
+        pwmStatus = PWM_ERROR;
+    else if ((duty_cycle[MM_PWMA_WHEEL_MOTOR_1_DUTY_CYCLE_INDEX] == 
+        motor1DutyCycle) && 
+        (duty_cycle[MM_PWMA_WHEEL_MOTOR_2_DUTY_CYCLE_INDEX] == 
+        motor2DutyCycle))
+        pwmStatus = PWM_SUCCESS;
+    else
+    {
+        /* change both PWM duty cycles w/ params */
+        duty_cycle[MM_PWMA_WHEEL_MOTOR_1_DUTY_CYCLE_INDEX] = motor1DutyCycle;
+        duty_cycle[MM_PWMA_WHEEL_MOTOR_2_DUTY_CYCLE_INDEX] = motor2DutyCycle;
+        
+        set_value_status = pwma_set_multiple_values(
+            pwma,
+            ((MM_PWMA_WHEEL_MOTOR_1_CHANNEL_ID << 0) |
+             (MM_PWMA_WHEEL_MOTOR_2_CHANNEL_ID << 8) |
+             (MM_PWMA_VACUUM_MOTOR_CHANNEL_ID << 16)),
+            (uint16_t*)&duty_cycle);
+
+        if (set_value_status == FAIL)
+            pwmStatus = PWM_ERROR;
+        else
+            pwmStatus = PWM_SUCCESS;
+    }
+    
+    /* return status */
+    return pwmStatus;
+}
+
 pwm_status_t at32uc3l0256_SetVacuumMotorDutyCycle(uint16_t dutyCycle)
 {
     pwm_status_t pwmStatus = PWM_ERROR;
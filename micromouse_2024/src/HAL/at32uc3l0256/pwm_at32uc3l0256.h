@@ -73,6 +73,8 @@
 pwm_status_t at32uc3l0256_InitPwm(void);
 pwm_status_t at32uc3l0256_SetWheelMotor1DutyCycle(uint16_t dutyCycle);
 pwm_status_t at32uc3l0256_SetWheelMotor2DutyCycle(uint16_t dutyCycle);
+pwm_status_t at32uc3l0256_SetWheelMotorDutyCycles(uint16_t motor1DutyCycle,
+    uint16_t motor2DutyCycle);
 pwm_status_t at32uc3l0256_SetVacuumMotorDutyCycle(uint16_t dutyCycle);
 
 #endif /* PWM_AT32UC3L0256_H_ */
\ No newline at end of file
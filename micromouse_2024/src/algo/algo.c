@@ -3,8 +3,12 @@
 #include "mouse_hardware_interface/usart_mhi.h"
 #include "mouse_control_interface/walldetection_mci.h"
 #include "mouse_control_interface/movement_mci.h"
+#include "shared_functions/fixedpoint_sf.h"
+#include "mouse_control_interface/odometry_mci.h"
 #include "mouse_hardware_interface/clock_mhi.h"
 #include "mouse_control_interface/configswitch_mci.h"
+#include "mouse_control_interface/vacuum_mci.h"
+#include "mouse_control_interface/time_mci.h"
 
 /* Variables */
 MouseState   state          = FIRST_TRAVERSAL;
@@ -31,13 +35,40 @@ Point        centerPoints[] =
 #endif
 unsigned int numCenterPoints = sizeof(centerPoints) / sizeof(Point);
 
+/* Planning ahead while moving */
+Point*       searchGoals    = NULL;
+unsigned int numSearchGoals = 0;
+Direction    travelDir      = NORTH;
+Point        travelPoint    = {0, 0};
+bool         planAheadTried = FALSE;
+bool         planAheadValid = FALSE;
+bool         planAheadFilling = FALSE;
+MazeCell     plannedCell    = {FALSE, FALSE, FALSE, FALSE};
+
+/* Flood fill- breadth first, so it can be advanced a few cells at a time */
+Point        floodQueue     [MAZE_LENGTH * MAZE_LENGTH];
+unsigned int floodHead      = 0;
+unsigned int floodTail      = 0;
+bool         floodOpen      = FALSE;
+
+/* Stall recovery- position is lost until the mouse is placed back */
+bool         moveStalled    = FALSE;
+
 /* Traversal */
 bool searchCell(Point goalPoints[], unsigned int numGoalPoints);
 bool runCell(Point goalPoints[], unsigned int numGoalPoints);
 
 /* Flood fill */
 void floodFill(Point destPoints[], unsigned int numPoints, bool open);
-void floodFillRecurse(Point point, unsigned int cost, bool open);
+void floodFillStart(Point destPoints[], unsigned int numPoints, bool open);
+bool floodFillStep(unsigned int maxCells);
+void floodFillVisit(Point point, bool wall, unsigned int cost);
+
+/* Planning ahead while moving */
+void setTravel(Direction direction);
+void planAhead(void);
+MazeCell relativeWalls(Direction heading, bool front, bool back, bool left, bool right);
+bool sameWalls(MazeCell a, MazeCell b);
 
 /* Utilities */
 unsigned int mazeIdx(Point point);
@@ -73,6 +104,11 @@ bool checkFrontWall(void);
 bool checkBackWall(void);
 bool checkLeftWall(void);
 bool checkRightWall(void);
+bool isConfidentWall(mci_wall_presence_t presence, unsigned int confidence);
+
+/* Sensor health */
+void expectWalls(void);
+void expectWall(Direction direction, Point neighbor, bool neighborOpen);
 
 /* State machine */
 typedef struct{
@@ -90,6 +126,7 @@ MouseState goToLastPoint();
 MouseState finished();
 void beginBacktrack(void);
 void beginRunToGoal(void);
+void endRun(void);
 StateTransition* getTransition(MouseState curState, MouseState nextState);
 
 MouseState (*stateFuncs[])(void) = {
@@ -110,7 +147,7 @@ StateTransition stateTransitions[] = {
 	{BACK_TO_START, RUN_TO_GOAL, beginRunToGoal},
 	{BACK_TO_START, RESET_2, resetMouse},
 	{RUN_TO_GOAL, RUN_TO_GOAL, NULL},
-	{RUN_TO_GOAL, FINISHED, NULL},
+	{RUN_TO_GOAL, FINISHED, endRun},
 	{RUN_TO_GOAL, RESET_2, resetMouse},
 	{RESET_1, GO_TO_LAST_POINT, NULL},
 	{RESET_1, RESET_1, NULL},
@@ -143,7 +180,7 @@ void algoIterate()
 
 MouseState firstTraversal()
 {
-	if(mci_CheckConfigButtonPressed())
+	if(mci_CheckConfigButtonPressed() || moveStalled)
 		return RESET_1;
 	
 	if(searchCell(centerPoints, numCenterPoints))
@@ -154,7 +191,7 @@ MouseState firstTraversal()
 
 MouseState backToStart()
 {
-	if(mci_CheckConfigButtonPressed())
+	if(mci_CheckConfigButtonPressed() || moveStalled)
 		return RESET_2;
 	
 	if(runCell(&startPoint, 1))
@@ -165,7 +202,7 @@ MouseState backToStart()
 
 MouseState runToGoal()
 {
-	if(mci_CheckConfigButtonPressed())
+	if(mci_CheckConfigButtonPressed() || moveStalled)
 		return RESET_2;
 	
 	if(runCell(&centerPoints, numCenterPoints))
@@ -208,6 +245,14 @@ void beginBacktrack(void)
 void beginRunToGoal(void)
 {
 	floodFill(centerPoints, numCenterPoints, FALSE);
+	
+	/* suction on for the speed run only */
+	mci_StartDownforce();
+}
+
+void endRun(void)
+{
+	mci_StopDownforce();
 }
 
 StateTransition* getTransition(MouseState curState, MouseState nextState)
@@ -232,10 +277,14 @@ bool searchCell(Point goalPoints[], unsigned int numGoalPoints)
 	{
 		thisCell = mazeDiscovered[mazeIdx(curPoint)] = checkWalls();
 		mazeVisited[mazeIdx(curPoint)] = TRUE;
-		floodFill(goalPoints, numGoalPoints, TRUE);
+		
+		/* flood fill from the last move still holds if the walls were guessed right */
+		if (!planAheadValid || !sameWalls(thisCell, plannedCell))
+			floodFill(goalPoints, numGoalPoints, TRUE);
 	}
 	else
 		thisCell = mazeDiscovered[mazeIdx(curPoint)];
+	planAheadValid = FALSE;
 
 	unsigned int cost = UINT_MAX;
 	Direction nextDir;
@@ -281,6 +330,10 @@ bool searchCell(Point goalPoints[], unsigned int numGoalPoints)
 				foundUnvisitedCell = TRUE;
 			}
 
+	/* let the move plan ahead for the square it enters */
+	searchGoals = goalPoints;
+	numSearchGoals = numGoalPoints;
+
 	if (foundUnvisitedCell)
 	{
 		move(nextDir);
@@ -292,6 +345,8 @@ bool searchCell(Point goalPoints[], unsigned int numGoalPoints)
 		moveBackward(poppedMove);
 	}
 
+	searchGoals = NULL;
+
 	if (containsPoint(goalPoints, numGoalPoints, curPoint))
 	{
 		mazeDiscovered[mazeIdx(curPoint)] = checkWalls();
@@ -359,49 +414,145 @@ bool runCell(Point goalPoints[], unsigned int numGoalPoints)
 }
 
 void floodFill(Point destPoints[], unsigned int numPoints, bool open)
+{
+	floodFillStart(destPoints, numPoints, open);
+	floodFillStep(MAZE_LENGTH * MAZE_LENGTH);
+}
+
+void floodFillStart(Point destPoints[], unsigned int numPoints, bool open)
 {
 	for (int i = 0; i < MAZE_LENGTH * MAZE_LENGTH; i++)
 		mazeFlood[i] = UINT_MAX;
 
+	floodHead = floodTail = 0;
+	floodOpen = open;
+
 	for (unsigned int i = 0; i < numPoints; i++)
 		if (open || mazeVisited[mazeIdx(destPoints[i])])
-			floodFillRecurse(destPoints[i], 0, open);
+			if (mazeFlood[mazeIdx(destPoints[i])] != 0)
+			{
+				mazeFlood[mazeIdx(destPoints[i])] = 0;
+				floodQueue[floodTail++] = destPoints[i];
+			}
 }
 
-void floodFillRecurse(Point point, unsigned int cost, bool open)
+/* Returns TRUE once every reachable cell has its cost */
+bool floodFillStep(unsigned int maxCells)
 {
-	unsigned int x = point.x, y = point.y;
-	MazeCell mc = mazeDiscovered[mazeIdx(point)];
-	mazeFlood[mazeIdx(point)] = cost;
+	while (floodHead < floodTail && maxCells > 0)
+	{
+		Point point = floodQueue[floodHead++];
+		unsigned int x = point.x, y = point.y;
+		unsigned int cost = mazeFlood[mazeIdx(point)] + 1;
+		MazeCell mc = mazeDiscovered[mazeIdx(point)];
+
+		Point northPoint = {x, y + 1};
+		Point southPoint = {x, y - 1};
+		Point eastPoint = {x + 1, y};
+		Point westPoint = {x - 1, y};
+
+		floodFillVisit(northPoint, mc.northWall, cost);
+		floodFillVisit(southPoint, mc.southWall, cost);
+		floodFillVisit(eastPoint, mc.eastWall, cost);
+		floodFillVisit(westPoint, mc.westWall, cost);
+
+		maxCells--;
+	}
 
-	Point northPoint = {x, y + 1};
-	Point southPoint = {x, y - 1};
-	Point eastPoint = {x + 1, y};
-	Point westPoint = {x - 1, y};
+	return floodHead == floodTail;
+}
 
-	if (isInRange(northPoint))
-		if (open || mazeVisited[mazeIdx(northPoint)])
-			if (!mc.northWall)
-				if (mazeFlood[mazeIdx(northPoint)] > cost + 1)
-					floodFillRecurse(northPoint, cost + 1, open);
+/* Breadth first reaches each cell at its lowest cost first, so it is queued once */
+void floodFillVisit(Point point, bool wall, unsigned int cost)
+{
+	if (isInRange(point))
+		if (floodOpen || mazeVisited[mazeIdx(point)])
+			if (!wall)
+				if (mazeFlood[mazeIdx(point)] > cost)
+				{
+					mazeFlood[mazeIdx(point)] = cost;
+					floodQueue[floodTail++] = point;
+				}
+}
 
-	if (isInRange(southPoint))
-		if (open || mazeVisited[mazeIdx(southPoint)])
-			if (!mc.southWall)
-				if (mazeFlood[mazeIdx(southPoint)] > cost + 1)
-					floodFillRecurse(southPoint, cost + 1, open);
+void setTravel(Direction direction)
+{
+	travelDir = direction;
+	travelPoint = curPoint;
+	
+	switch (direction)
+	{
+		case NORTH:
+			travelPoint.y++;
+			break;
+		case SOUTH:
+			travelPoint.y--;
+			break;
+		case EAST:
+			travelPoint.x++;
+			break;
+		case WEST:
+			travelPoint.x--;
+			break;
+	}
+}
 
-	if (isInRange(eastPoint))
-		if (open || mazeVisited[mazeIdx(eastPoint)])
-			if (!mc.eastWall)
-				if (mazeFlood[mazeIdx(eastPoint)] > cost + 1)
-					floodFillRecurse(eastPoint, cost + 1, open);
+void planAhead(void)
+{
+	planAheadTried = TRUE;
+	
+	if (searchGoals == NULL || !isInRange(travelPoint) || isExplored(travelPoint))
+		return;
+	
+	/* side walls are latched, guess the front wall is open */
+	plannedCell = relativeWalls(travelDir, FALSE,
+		travelPoint.x == 0 && travelPoint.y == 0, checkLeftWall(), checkRightWall());
+	mazeDiscovered[mazeIdx(travelPoint)] = plannedCell;
+	
+	/* the move polls advance the fill between control ticks */
+	floodFillStart(searchGoals, numSearchGoals, TRUE);
+	planAheadFilling = TRUE;
+}
 
-	if (isInRange(westPoint))
-		if (open || mazeVisited[mazeIdx(westPoint)])
-			if (!mc.westWall)
-				if (mazeFlood[mazeIdx(westPoint)] > cost + 1)
-					floodFillRecurse(westPoint, cost + 1, open);
+MazeCell relativeWalls(Direction heading, bool front, bool back, bool left, bool right)
+{
+	MazeCell cell;
+	
+	switch (heading)
+	{
+		case NORTH:
+			cell.northWall = front;
+			cell.southWall = back;
+			cell.eastWall  = right;
+			cell.westWall  = left;
+			break;
+		case SOUTH:
+			cell.northWall = back;
+			cell.southWall = front;
+			cell.eastWall  = left;
+			cell.westWall  = right;
+			break;
+		case EAST:
+			cell.northWall = left;
+			cell.southWall = right;
+			cell.eastWall  = front;
+			cell.westWall  = back;
+			break;
+		case WEST:
+			cell.northWall = right;
+			cell.southWall = left;
+			cell.eastWall  = back;
+			cell.westWall  = front;
+			break;
+	}
+	
+	return cell;
+}
+
+bool sameWalls(MazeCell a, MazeCell b)
+{
+	return a.northWall == b.northWall && a.southWall == b.southWall &&
+		a.eastWall == b.eastWall && a.westWall == b.westWall;
 }
 
 unsigned int mazeIdx(Point point)
@@ -435,8 +586,11 @@ bool isExplored(Point point)
 
 void resetMouse()
 {
+	mci_StopDownforce();
+	moveStalled = FALSE;
 	curPoint.x = curPoint.y = 0;
 	curDir = NORTH;
+	mci_ResetPose();
 }
 
 char pop(Direction *stack, unsigned int *top)
@@ -504,35 +658,72 @@ void moveBackward(Direction direction)
 
 void moveForward(void)
 {
-	mci_MoveForward1MazeSquarePid();
+	mci_move_status_t status;
+	
+	if (moveStalled)
+		return;
+	
+	planAheadTried = FALSE;
+	planAheadFilling = FALSE;
+	mci_StartMoveForward1MazeSquarePid();
+	
+	/* plan for the next square once its side walls are latched- a few */
+	/* cells per poll, never past the start of the next control tick */
+	while ((status = mci_PollMove()) == MCI_MOVE_RUNNING)
+	{
+		if (!planAheadTried && mci_CheckMoveWallsLatched())
+			planAhead();
+		else if (planAheadFilling && !mci_PeekControlTick())
+			if (floodFillStep(FLOOD_FILL_STEP_CELLS))
+			{
+				planAheadFilling = FALSE;
+				planAheadValid = TRUE;
+			}
+	}
+	
+	/* a fill the move outran is redone in full at the next square */
+	planAheadFilling = FALSE;
+	
+	if (status == MCI_MOVE_STALLED)
+		moveStalled = TRUE;
+	
 	mhi_DelayMs(80);
 }
 
 void moveBack(void)
 {
-	mci_TurnRight90DegreesPID();
-	mhi_DelayMs(100);
-	mci_TurnRight90DegreesPID();
-	mhi_DelayMs(100);
+	/* dead end- the front wall becomes a back wall to square up on. Only */
+	/* walls actually seen count, the mouse is about to reverse into it */
+	bool deadEnd = isConfidentWall(mci_CheckFrontWall(), mci_GetFrontWallConfidence()) &&
+		isConfidentWall(mci_CheckLeftWall(), mci_GetLeftWallConfidence()) &&
+		isConfidentWall(mci_CheckRightWall(), mci_GetRightWallConfidence());
+
+	/* one continuous about turn- it settles before returning */
+	if (mci_TurnByAngle(180, mci_GetTurnProfile()) == MCI_MOVE_STALLED)
+		moveStalled = TRUE;
+	else if (deadEnd && (mci_RecalibrateOnBackWall() == MCI_MOVE_STALLED))
+		moveStalled = TRUE;
 	moveForward();
 }
 
 void moveLeft(void)
 {
-	mci_TurnLeft90DegreesPID();
-	mhi_DelayMs(100);
+	if (mci_TurnByAngle(-90, mci_GetTurnProfile()) == MCI_MOVE_STALLED)
+		moveStalled = TRUE;
 	moveForward();
 }
 
 void moveRight(void)
 {
-	mci_TurnRight90DegreesPID();
-	mhi_DelayMs(100);
+	if (mci_TurnByAngle(90, mci_GetTurnProfile()) == MCI_MOVE_STALLED)
+		moveStalled = TRUE;
 	moveForward();
 }
 
 void moveNorth(void)
 {
+	setTravel(NORTH);
+	
 	switch (curDir)
 	{
 		case NORTH:
@@ -554,6 +745,8 @@ void moveNorth(void)
 
 void moveSouth(void)
 {
+	setTravel(SOUTH);
+	
 	switch (curDir)
 	{
 		case NORTH:
@@ -575,6 +768,8 @@ void moveSouth(void)
 
 void moveEast(void)
 {
+	setTravel(EAST);
+	
 	switch (curDir)
 	{
 		case NORTH:
@@ -596,6 +791,8 @@ void moveEast(void)
 
 void moveWest(void)
 {
+	setTravel(WEST);
+	
 	switch (curDir)
 	{
 		case NORTH:
@@ -623,6 +820,8 @@ MazeCell checkWalls()
 	cell.southWall = checkSouthWall();
 	cell.eastWall  = checkEastWall();
 	cell.westWall  = checkWestWall();
+	
+	expectWalls();
 		
 	return cell;
 }
@@ -685,7 +884,8 @@ bool checkWestWall(void)
 
 bool checkFrontWall(void)
 {
-	if (mci_CheckFrontWall() == MCI_WALL_NOT_FOUND)
+	if (mci_CheckFrontWall() == MCI_WALL_NOT_FOUND &&
+		mci_GetFrontWallConfidence() >= WALL_CONFIDENCE_MINIMUM)
 		return FALSE;
 	
 	return TRUE;
@@ -701,7 +901,9 @@ bool checkBackWall(void)
 
 bool checkLeftWall(void)
 {
-	if (mci_CheckLeftWall() == MCI_WALL_NOT_FOUND)
+	/* an opening the evidence is unsure of stays closed in the map */
+	if (mci_CheckLeftWall() == MCI_WALL_NOT_FOUND &&
+		mci_GetLeftWallConfidence() >= WALL_CONFIDENCE_MINIMUM)
 		return FALSE;
 	
 	return TRUE;
@@ -709,8 +911,78 @@ bool checkLeftWall(void)
 
 bool checkRightWall(void)
 {
-	if (mci_CheckRightWall() == MCI_WALL_NOT_FOUND)
+	/* an opening the evidence is unsure of stays closed in the map */
+	if (mci_CheckRightWall() == MCI_WALL_NOT_FOUND &&
+		mci_GetRightWallConfidence() >= WALL_CONFIDENCE_MINIMUM)
 		return FALSE;
 	
 	return TRUE;
 }
+
+/* A wall seen w/ enough evidence- unlike the checks above, not-sure is no wall */
+bool isConfidentWall(mci_wall_presence_t presence, unsigned int confidence)
+{
+	return presence == MCI_WALL_FOUND && confidence >= WALL_CONFIDENCE_MINIMUM;
+}
+
+/* Let the sensors know about walls the map is sure of- outer walls and openings
+   seen from the neighbouring square- so one that keeps disagreeing is dropped */
+void expectWalls(void)
+{
+	Point northPoint = {curPoint.x, curPoint.y + 1};
+	Point eastPoint = {curPoint.x + 1, curPoint.y};
+	Point southPoint = {curPoint.x, curPoint.y - 1};
+	Point westPoint = {curPoint.x - 1, curPoint.y};
+	
+	expectWall(NORTH, northPoint, 
+		isInRange(northPoint) && !mazeDiscovered[mazeIdx(northPoint)].southWall);
+	expectWall(EAST, eastPoint, 
+		isInRange(eastPoint) && !mazeDiscovered[mazeIdx(eastPoint)].westWall);
+	expectWall(SOUTH, southPoint, 
+		isInRange(southPoint) && !mazeDiscovered[mazeIdx(southPoint)].northWall);
+	expectWall(WEST, westPoint, 
+		isInRange(westPoint) && !mazeDiscovered[mazeIdx(westPoint)].eastWall);
+}
+
+void expectWall(Direction direction, Point neighbor, bool neighborOpen)
+{
+	mci_wall_presence_t expected;
+	Direction leftDir;
+	Direction rightDir;
+	
+	if (!isInRange(neighbor))
+		expected = MCI_WALL_FOUND;
+	else if (mazeVisited[mazeIdx(neighbor)] && neighborOpen)
+		expected = MCI_WALL_NOT_FOUND;
+	else
+		return;
+	
+	switch (curDir)
+	{
+		case NORTH:
+			leftDir = WEST;
+			rightDir = EAST;
+			break;
+		case SOUTH:
+			leftDir = EAST;
+			rightDir = WEST;
+			break;
+		case EAST:
+			leftDir = NORTH;
+			rightDir = SOUTH;
+			break;
+		case WEST:
+			leftDir = SOUTH;
+			rightDir = NORTH;
+			break;
+		default:
+			return;
+	}
+	
+	if (direction == curDir)
+		mci_ExpectFrontWall(expected);
+	else if (direction == leftDir)
+		mci_ExpectLeftWall(expected);
+	else if (direction == rightDir)
+		mci_ExpectRightWall(expected);
+}
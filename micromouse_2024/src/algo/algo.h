@@ -6,6 +6,12 @@
 #define UINT_MAX   65535
 #define STACK_SIZE 1000
 
+/* cells the plan ahead flood fill advances per poll between control ticks */
+#define FLOOD_FILL_STEP_CELLS 8
+
+/* openings seen w/ less wall confidence than this are mapped as walls */
+#define WALL_CONFIDENCE_MINIMUM 25
+
 /* Typedefs */
 typedef enum
 {
@@ -23,6 +23,9 @@
 #include "mouse_control_interface/movement_mci.h"
 #include "mouse_control_interface/configswitch_mci.h"
 #include "mouse_control_interface/time_mci.h"
+#include "mouse_control_interface/autotune_mci.h"
+#include "mouse_control_interface/motorcal_mci.h"
+#include "mouse_control_interface/ircal_mci.h"
 #include "algo/algo.h"
 
 #include "algo/algo.h"
@@ -67,17 +70,39 @@
 /*----------------------------------------------------------------------------*/
 int main (void)
 {   
+    mci_startup_mode_t startupMode = MCI_STARTUP_MODE_RUN;
+    
     /* initialize mouse */
     mci_InitializeMouse();
     
+    /* tune or calibrate instead of running if requested */
+    startupMode = mci_SelectStartupMode();
+    if (startupMode == MCI_STARTUP_MODE_AUTOTUNE)
+    {
+        mci_RunAutotune();
+    }
+    else if (startupMode == MCI_STARTUP_MODE_MOTORCAL)
+    {
+        mci_CharacterizeWheelMotors();
+    }
+    else if (startupMode == MCI_STARTUP_MODE_IRCAL)
+    {
+        mci_CalibrateIrSensors();
+    }
+    
+    /* stay put until the mouse is placed back at the start */
+    if (startupMode != MCI_STARTUP_MODE_RUN)
+    {
+        while (mci_CheckConfigButtonPressed() == MCI_BUTTON_NOT_PRESSED)
+        {
+        }
+    }
+    
     while(1)
     {
 	    //mhi_CheckLowBattery();
 	    
 	    algoIterate();
-	    if(mci_CheckFrontWall()){
-		    mci_AdjustToFrontWall();
-	    }
 	    
     }
 }
@@ -20,6 +20,9 @@
 #define MCI_MAZE_WALL_LENGTH_MM                 (180)
 /* width of maze pillar from side to side in millimeters */
 #define MCI_MAZE_PILLAR_WIDTH_MM                (12)
+/* maze square = wall + pillar, also the distance between cell centers */
+#define MCI_MAZE_SQUARE_LENGTH_MM \
+    (MCI_MAZE_WALL_LENGTH_MM + MCI_MAZE_PILLAR_WIDTH_MM)
 
 /* IR sensor reading tolerances */
 #define MCI_FRONT_SENSOR_READING_TOLERANCE      (10)
@@ -0,0 +1,305 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : autotune_mci.c
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-04-13
+* Purpose         : mouse control interface layer
+*
+* This is the source file for controller autotuning under the mouse control
+* interface.
+*
+* The mouse control interface uses the mouse hardware interface to define high
+* level micromouse functionality.
+*-----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include "micromouse_dimensions.h"
+#include "shared_functions/fixedpoint_sf.h"
+#include "mouse_hardware_interface/leds_mhi.h"
+#include "mouse_hardware_interface/usart_mhi.h"
+#include "mouse_hardware_interface/motors_mhi.h"
+#include "mouse_hardware_interface/interrupts_mhi.h"
+#include "mouse_control_interface/walldetection_mci.h"
+#include "mouse_control_interface/movement_mci.h"
+#include "mouse_control_interface/odometry_mci.h"
+#include "mouse_control_interface/settings_mci.h"
+#include "mouse_control_interface/time_mci.h"
+#include "mouse_control_interface/gainschedule_mci.h"
+#include "mouse_control_interface/autotune_mci.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+/* relay output in linear wheel speed and switching hysteresis in edges */
+/* the wheel tables start at the deadband, so the relay always turns the */
+/* wheels- the default tables raise 80 to the minimum duty cycle. The gains */
+/* found are the gain schedule's 1.0 point */
+#define MCI_AUTOTUNE_RELAY_AMPLITUDE    MCI_GAIN_SCHEDULE_TUNED_SPEED
+#define MCI_AUTOTUNE_RELAY_HYSTERESIS   (1)
+
+/* cycles to let the oscillation settle, then cycles to average */
+#define MCI_AUTOTUNE_SKIP_CYCLES        (2u)
+#define MCI_AUTOTUNE_MEASURE_CYCLES     (4u)
+
+/* give up if the loop never settles into a limit cycle */
+#define MCI_AUTOTUNE_TIMEOUT_MS         (4000u)
+
+/* pause between experiments so the mouse comes to rest */
+#define MCI_AUTOTUNE_REST_MS            (500u)
+
+/* pi scaled by 1000 for the describing function gain */
+#define MCI_AUTOTUNE_PI_X1000           (3142)
+
+/* Ziegler-Nichols PD rules- Kp = 0.8 Ku, Td = Tu / 8 */
+#define MCI_AUTOTUNE_KP_PER_KU          SF_Q16_FROM_FLOAT(0.8f)
+#define MCI_AUTOTUNE_TD_DIVISOR         (8)
+
+/* which way the relay drives the wheels */
+typedef enum
+{
+    MCI_AUTOTUNE_DIFFERENTIAL = 0u,     /* opposite directions, heading */
+    MCI_AUTOTUNE_COMMON_MODE            /* same direction, wheel position */
+} mci_autotune_mode_t;
+
+/*----------------------------------------------------------------------------*/
+/*                               Debug Switches                               */
+/*----------------------------------------------------------------------------*/
+/* 1 = Enable Debug Trace Output */
+#define DEBUG_MCI_AUTOTUNE_ENABLE    (1)
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                    Private (Static) Function Prototype                     */
+/*----------------------------------------------------------------------------*/
+static mci_autotune_status_t mci_RunRelayExperiment(mci_autotune_mode_t mode,
+    mci_pid_gains_t *p_gains);
+static int32_t mci_ReadRelayFeedback(mci_autotune_mode_t mode);
+static void mci_DriveRelay(mci_autotune_mode_t mode, int32_t output);
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+/**
+* Tune the straight move wheel difference loop
+*
+* Mouse rocks in place about its starting heading. Gains are only applied to
+* the current settings- call mci_SaveSettings() to keep them.
+*
+* \param None
+* \retval MCI_AUTOTUNE_DONE Heading gains updated
+* \retval MCI_AUTOTUNE_FAILED No limit cycle found, gains left alone
+*/
+mci_autotune_status_t mci_AutotuneHeadingLoop(void)
+{
+    return mci_RunRelayExperiment(MCI_AUTOTUNE_DIFFERENTIAL, 
+        &mci_GetSettings()->headingGains);
+}
+
+/**
+* Tune the turn per wheel position loop
+*
+* Mouse rocks back and forth about its starting position. Gains are only
+* applied to the current settings- call mci_SaveSettings() to keep them.
+*
+* \param None
+* \retval MCI_AUTOTUNE_DONE Wheel gains updated
+* \retval MCI_AUTOTUNE_FAILED No limit cycle found, gains left alone
+*/
+mci_autotune_status_t mci_AutotuneWheelLoop(void)
+{
+    return mci_RunRelayExperiment(MCI_AUTOTUNE_COMMON_MODE, 
+        &mci_GetSettings()->wheelGains);
+}
+
+/**
+* Tune every loop that can be tuned on the spot and save the new gains
+*
+* Side wall centering needs walls to move past, so its gains are kept. 
+* Settings are only saved if every experiment succeeds.
+*
+* \param None
+* \retval MCI_AUTOTUNE_DONE New gains saved
+* \retval MCI_AUTOTUNE_FAILED Stored gains left alone
+*/
+mci_autotune_status_t mci_RunAutotune(void)
+{
+    mci_autotune_status_t status = MCI_AUTOTUNE_FAILED;
+    
+    mhi_SetD1Led();
+    
+    status = mci_AutotuneHeadingLoop();
+    if (status == MCI_AUTOTUNE_DONE)
+    {
+        mci_DelayMs(MCI_AUTOTUNE_REST_MS);
+        status = mci_AutotuneWheelLoop();
+    }
+    
+    if (status == MCI_AUTOTUNE_DONE)
+    {
+        mci_SaveSettings();
+    }
+    else
+    {
+        /* drop any gains the first experiment changed */
+        mci_LoadSettings();
+        
+#if defined(DEBUG_MCI_AUTOTUNE_ENABLE) && (DEBUG_MCI_AUTOTUNE_ENABLE == 1)
+        mhi_PrintString("Autotune failed\r\n");
+#endif /* DEBUG_MCI_AUTOTUNE_ENABLE */
+    }
+    
+    mhi_ClearD1Led();
+    
+    return status;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                           Local Shared Functions                           */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                         Private (Static) Functions                         */
+/*----------------------------------------------------------------------------*/
+/**
+* Run a relay feedback experiment and compute PD gains from its limit cycle
+*
+* The relay switches on the encoder feedback once per control tick, so the
+* measured period and the resulting derivative gain are in control ticks.
+*
+* \param[in] mode Wheel drive pattern and feedback the relay works on
+* \param[out] p_gains Gains to update on success
+* \retval MCI_AUTOTUNE_DONE Gains updated
+* \retval MCI_AUTOTUNE_FAILED Timed out, gains left alone
+*/
+static mci_autotune_status_t mci_RunRelayExperiment(mci_autotune_mode_t mode,
+    mci_pid_gains_t *p_gains)
+{
+    mci_autotune_status_t status = MCI_AUTOTUNE_FAILED;
+    uint32_t elapsedMs = 0u;
+    uint32_t cycles = 0u;
+    uint32_t cycleTicks = 0u;
+    uint32_t periodSum = 0u;
+    int32_t peakToPeakSum = 0;
+    int32_t feedback = 0;
+    int32_t output = MCI_AUTOTUNE_RELAY_AMPLITUDE;
+    int32_t cycleMax = 0;
+    int32_t cycleMin = 0;
+    int64_t ultimateGain = 0;
+    sf_q16_t kp = 0;
+    
+    mci_ClearEncoderCounts();
+    mci_DriveRelay(mode, output);
+    
+    while ((elapsedMs < MCI_AUTOTUNE_TIMEOUT_MS) && 
+        (cycles < (MCI_AUTOTUNE_SKIP_CYCLES + MCI_AUTOTUNE_MEASURE_CYCLES)))
+    {
+        mci_WaitForControlTick();
+        mci_UpdateOdometry();
+        elapsedMs += MCI_CONTROL_TICK_MS;
+        cycleTicks++;
+        
+        feedback = mci_ReadRelayFeedback(mode);
+        cycleMax = (feedback > cycleMax) ? feedback : cycleMax;
+        cycleMin = (feedback < cycleMin) ? feedback : cycleMin;
+        
+        /* negative feedback w/ hysteresis- a cycle ends on each upper switch */
+        if ((output > 0) && (feedback > MCI_AUTOTUNE_RELAY_HYSTERESIS))
+        {
+            output = -MCI_AUTOTUNE_RELAY_AMPLITUDE;
+            
+            if (cycles >= MCI_AUTOTUNE_SKIP_CYCLES)
+            {
+                periodSum += cycleTicks;
+                peakToPeakSum += cycleMax - cycleMin;
+            }
+            cycles++;
+            cycleTicks = 0u;
+            cycleMax = feedback;
+            cycleMin = feedback;
+        }
+        else if ((output < 0) && (feedback < -MCI_AUTOTUNE_RELAY_HYSTERESIS))
+        {
+            output = MCI_AUTOTUNE_RELAY_AMPLITUDE;
+        }
+        
+        mci_DriveRelay(mode, output);
+    }
+    
+    mhi_StopWheelMotor1();
+    mhi_StopWheelMotor2();
+    mci_ClearEncoderCounts();
+    
+    if ((cycles >= (MCI_AUTOTUNE_SKIP_CYCLES + MCI_AUTOTUNE_MEASURE_CYCLES)) && 
+        (peakToPeakSum > 0))
+    {
+        /* Ku = 4 d / (pi a) w/ a the mean half peak to peak amplitude */
+        ultimateGain = ((int64_t)8 * MCI_AUTOTUNE_RELAY_AMPLITUDE * 
+            MCI_AUTOTUNE_MEASURE_CYCLES * 1000 * SF_Q16_ONE) / 
+            ((int64_t)MCI_AUTOTUNE_PI_X1000 * peakToPeakSum);
+        kp = sf_Q16Mul(sf_Q16Saturate(ultimateGain), MCI_AUTOTUNE_KP_PER_KU);
+        
+        /* Kd = Kp Td w/ Td = Tu / 8 and Tu the mean period in ticks */
+        p_gains->kp = kp;
+        p_gains->ki = 0;
+        p_gains->kd = sf_Q16Saturate(((int64_t)kp * periodSum) / 
+            ((int64_t)MCI_AUTOTUNE_TD_DIVISOR * MCI_AUTOTUNE_MEASURE_CYCLES));
+        status = MCI_AUTOTUNE_DONE;
+        
+#if defined(DEBUG_MCI_AUTOTUNE_ENABLE) && (DEBUG_MCI_AUTOTUNE_ENABLE == 1)
+        mhi_PrintString("Autotune Kp x1000: ");
+        mhi_PrintInt((unsigned long)sf_Q16MulInt(p_gains->kp, 1000));
+        mhi_PrintString(" Kd x1000: ");
+        mhi_PrintInt((unsigned long)sf_Q16MulInt(p_gains->kd, 1000));
+        mhi_PrintString("\r\n");
+#endif /* DEBUG_MCI_AUTOTUNE_ENABLE */
+    }
+    
+    return status;
+}
+
+/**
+* Read the encoder feedback the relay works on
+*
+* \param[in] mode Wheel drive pattern in use
+* \retval edge count difference (differential) or mean (common mode)
+*/
+static int32_t mci_ReadRelayFeedback(mci_autotune_mode_t mode)
+{
+    int32_t encoder1 = (int32_t)mhi_GetEncoder1EdgeCount();
+    int32_t encoder2 = (int32_t)mhi_GetEncoder2EdgeCount();
+    
+    if (mode == MCI_AUTOTUNE_DIFFERENTIAL)
+    {
+        return encoder1 - encoder2;
+    }
+    
+    return (encoder1 + encoder2) / 2;
+}
+
+/**
+* Drive the wheels w/ the relay output
+*
+* \param[in] mode Wheel drive pattern in use
+* \param[in] output Signed relay output in wheel speed
+* \retval None
+*/
+static void mci_DriveRelay(mci_autotune_mode_t mode, int32_t output)
+{
+    if (mode == MCI_AUTOTUNE_DIFFERENTIAL)
+    {
+        mci_DriveWheels(output, -output);
+    }
+    else
+    {
+        mci_DriveWheels(output, output);
+    }
+}
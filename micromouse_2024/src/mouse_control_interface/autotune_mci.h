@@ -0,0 +1,43 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : autotune_mci.h
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-04-13
+* Purpose         : mouse control interface layer
+*
+* This is the header file for controller autotuning under the mouse control
+* interface.
+*
+* Each loop is put under relay feedback until it settles into a limit cycle.
+* The cycle period and amplitude give the ultimate gain and period, which are
+* turned into PD gains w/ Ziegler-Nichols rules and saved to the settings.
+*
+* The mouse control interface uses the mouse hardware interface to define high
+* level micromouse functionality.
+*-----------------------------------------------------------------------------*/
+
+#ifndef AUTOTUNE_MCI_H_
+#define AUTOTUNE_MCI_H_
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+typedef enum
+{
+    MCI_AUTOTUNE_DONE = 0u,
+    MCI_AUTOTUNE_FAILED
+} mci_autotune_status_t;
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+mci_autotune_status_t mci_AutotuneHeadingLoop(void);
+mci_autotune_status_t mci_AutotuneWheelLoop(void);
+mci_autotune_status_t mci_RunAutotune(void);
+
+#endif /* AUTOTUNE_MCI_H_ */
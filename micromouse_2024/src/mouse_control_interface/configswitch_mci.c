@@ -21,12 +21,16 @@
 #include "micromouse_dimensions.h"
 #include "mouse_hardware_interface/leds_mhi.h"
 #include "mouse_hardware_interface/interrupts_mhi.h"
+#include "mouse_hardware_interface/timer_mhi.h"
 #include "mouse_control_interface/configswitch_mci.h"
+#include "mouse_control_interface/time_mci.h"
 
 /*----------------------------------------------------------------------------*/
 /*                                Definitions                                 */
 /*----------------------------------------------------------------------------*/
-/* None */
+/* the button is not debounced in hardware- edges this soon after a counted */
+/* press are contact bounce */
+#define MCI_CONFIG_BUTTON_DEBOUNCE_MS    (50u)
 
 /*----------------------------------------------------------------------------*/
 /*                               Debug Switches                               */
@@ -39,6 +43,7 @@
 /*----------------------------------------------------------------------------*/
 static uint32_t oldEdgeCount = 0u;
 static uint32_t newEdgeCount = 0u;
+static uint32_t lastPressTick = 0u;
 
 /*----------------------------------------------------------------------------*/
 /*                    Private (Static) Function Prototype                     */
@@ -51,17 +56,29 @@ static uint32_t newEdgeCount = 0u;
 /**
 * Check whether the config button has been pressed
 *
+* Edges within MCI_CONFIG_BUTTON_DEBOUNCE_MS of the last counted press are
+* dropped so one press w/ contact bounce counts once.
+*
 * \param None
 * \retval None
 */
 mci_button_pressed_t mci_CheckConfigButtonPressed(void)
 {
     mci_button_pressed_t buttonPressed = MCI_BUTTON_NOT_PRESSED;
+    uint32_t currentTick = 0u;
     
     newEdgeCount = mhi_GetConfigPinEdgeCount();
     if (newEdgeCount != oldEdgeCount)
     {
-        buttonPressed = MCI_BUTTON_PRESSED;
+        currentTick = mhi_GetTimerCount();
+        if (((currentTick - lastPressTick) * MCI_CONTROL_TICK_MS) >= 
+            MCI_CONFIG_BUTTON_DEBOUNCE_MS)
+        {
+            buttonPressed = MCI_BUTTON_PRESSED;
+            lastPressTick = currentTick;
+        }
+        
+        /* bounce edges are used up either way */
         oldEdgeCount = newEdgeCount;
     }
     else
@@ -72,6 +89,41 @@ mci_button_pressed_t mci_CheckConfigButtonPressed(void)
     return buttonPressed;
 }
 
+/**
+* Count config button presses after reset to pick a startup mode
+*
+* D3 toggles on every press so the count can be followed. Presses past the
+* last mode pick the last mode.
+*
+* \param None
+* \retval selected startup mode
+*/
+mci_startup_mode_t mci_SelectStartupMode(void)
+{
+    uint32_t presses = 0u;
+    
+    /* ignore presses from before the window */
+    oldEdgeCount = mhi_GetConfigPinEdgeCount();
+    
+    mci_ResetTimer();
+    while (mci_GetTimeMs() < MCI_STARTUP_MODE_WINDOW_MS)
+    {
+        if (mci_CheckConfigButtonPressed() == MCI_BUTTON_PRESSED)
+        {
+            presses++;
+            mhi_ToggleD3Led();
+        }
+    }
+    mhi_ClearD3Led();
+    
+    if (presses > (uint32_t)MCI_STARTUP_MODE_IRCAL)
+    {
+        presses = (uint32_t)MCI_STARTUP_MODE_IRCAL;
+    }
+    
+    return (mci_startup_mode_t)presses;
+}
+
 /*----------------------------------------------------------------------------*/
 /*                           Local Shared Functions                           */
 /*----------------------------------------------------------------------------*/
@@ -24,6 +24,18 @@ typedef enum
     MCI_BUTTON_PRESSED
 } mci_button_pressed_t;
 
+/* startup mode is picked by the number of button presses after reset */
+typedef enum
+{
+    MCI_STARTUP_MODE_RUN = 0u,          /* no presses */
+    MCI_STARTUP_MODE_AUTOTUNE,          /* one press */
+    MCI_STARTUP_MODE_MOTORCAL,          /* two presses */
+    MCI_STARTUP_MODE_IRCAL              /* three presses */
+} mci_startup_mode_t;
+
+/* time after reset to pick a startup mode */
+#define MCI_STARTUP_MODE_WINDOW_MS    (2000u)
+
 /*----------------------------------------------------------------------------*/
 /*                              Global Variables                              */
 /*----------------------------------------------------------------------------*/
@@ -33,5 +45,6 @@ typedef enum
 /*                       Public (Exportable) Functions                        */
 /*----------------------------------------------------------------------------*/
 mci_button_pressed_t mci_CheckConfigButtonPressed(void);
+mci_startup_mode_t mci_SelectStartupMode(void);
 
 #endif /* CONFIGSWITCH_MCI_H_ */
\ No newline at end of file
@@ -0,0 +1,183 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : gainschedule_mci.c
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-04-13
+* Purpose         : mouse control interface layer
+*
+* This is the source file for speed dependent gain scheduling under the
+* mouse control interface.
+*
+* The mouse control interface uses the mouse hardware interface to define high
+* level micromouse functionality.
+*-----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdlib.h>
+#include "shared_functions/fixedpoint_sf.h"
+#include "mouse_control_interface/settings_mci.h"
+#include "mouse_control_interface/walldetection_mci.h"
+#include "mouse_control_interface/movement_mci.h"
+#include "mouse_control_interface/gainschedule_mci.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+/* scale at a table point on a line through level at the tuned speed, */
+/* slope is the change in scale from speed 0 to full speed */
+#define MCI_GAIN_SCALE(level, slope, point) \
+    SF_Q16_FROM_FLOAT((level) + ((slope) * (float)((point) - \
+    MCI_GAIN_SCHEDULE_TUNED_SPEED) / 256.0f))
+
+/* one table row from a manoeuvre's kp and kd lines */
+#define MCI_GAIN_SCALE_ROW(level, kpSlope, kdSlope) \
+    { \
+        {MCI_GAIN_SCALE(level, kpSlope, 0), MCI_GAIN_SCALE(1.0f, kdSlope, 0)}, \
+        {MCI_GAIN_SCALE(level, kpSlope, 64), \
+            MCI_GAIN_SCALE(1.0f, kdSlope, 64)}, \
+        {MCI_GAIN_SCALE(level, kpSlope, 128), \
+            MCI_GAIN_SCALE(1.0f, kdSlope, 128)}, \
+        {MCI_GAIN_SCALE(level, kpSlope, 192), \
+            MCI_GAIN_SCALE(1.0f, kdSlope, 192)}, \
+        {MCI_GAIN_SCALE(level, kpSlope, 256), \
+            MCI_GAIN_SCALE(1.0f, kdSlope, 256)} \
+    }
+
+/* proportional (and integral) and derivative scales at one table point */
+typedef struct
+{
+    sf_q16_t kpScale;
+    sf_q16_t kdScale;
+} mci_gain_scale_t;
+
+/*----------------------------------------------------------------------------*/
+/*                               Debug Switches                               */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+/*
+* Scales are 1.0 at MCI_GAIN_SCHEDULE_TUNED_SPEED, where the settings gains
+* are tuned, and change linearly w/ speed from there. Faster, the same
+* heading error grows quicker per tick- less proportional and more
+* derivative keeps the loops from oscillating. Slower, more proportional
+* gets the wheels past friction.
+*
+* Each row is a level and two slopes. The level is below 1.0 only for
+* diagonals, where posts pass closer and centering has to be softer. The
+* slopes are first estimates, about half of kp per full speed for straights
+* where the sensor loop sees the speed the most, less for turns that only
+* run the encoder loop. A row is retuned by checking the loop at top speed
+* and setting its slopes from the kp and kd that hold there.
+*/
+static const mci_gain_scale_t gainScheduleTable[MCI_MANOEUVRE_COUNT]
+    [MCI_GAIN_SCHEDULE_POINTS] =
+{
+    /* MCI_MANOEUVRE_STRAIGHT */
+    MCI_GAIN_SCALE_ROW(1.00f, -0.55f, 0.50f),
+    /* MCI_MANOEUVRE_DIAGONAL */
+    MCI_GAIN_SCALE_ROW(0.90f, -0.50f, 0.40f),
+    /* MCI_MANOEUVRE_PIVOT */
+    MCI_GAIN_SCALE_ROW(1.00f, -0.40f, 0.30f),
+    /* MCI_MANOEUVRE_ARC */
+    MCI_GAIN_SCALE_ROW(1.00f, -0.40f, 0.40f)
+};
+
+/*----------------------------------------------------------------------------*/
+/*                    Private (Static) Function Prototype                     */
+/*----------------------------------------------------------------------------*/
+static sf_q16_t mci_InterpolateScale(sf_q16_t lowScale, sf_q16_t highScale,
+    uint32_t fraction);
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+/**
+* Scale base gains for a manoeuvre at a commanded speed
+*
+* The integral gain follows the proportional scale.
+*
+* \param[in] manoeuvre Manoeuvre type the gains are for
+* \param[in] speed Commanded speed, sign is ignored
+* \param[in] p_baseGains Gains tuned at MCI_GAIN_SCHEDULE_TUNED_SPEED
+* \param[out] p_gains Scheduled gains
+* \retval None
+*/
+void mci_ScheduleGains(mci_manoeuvre_t manoeuvre, int32_t speed,
+    const mci_pid_gains_t *p_baseGains, mci_pid_gains_t *p_gains)
+{
+    const mci_gain_scale_t *p_row = gainScheduleTable[MCI_MANOEUVRE_STRAIGHT];
+    uint32_t index = 0u;
+    uint32_t fraction = 0u;
+    sf_q16_t kpScale = SF_Q16_ONE;
+    sf_q16_t kdScale = SF_Q16_ONE;
+    
+    if (manoeuvre < MCI_MANOEUVRE_COUNT)
+    {
+        p_row = gainScheduleTable[manoeuvre];
+    }
+    
+    speed = abs(speed);
+    if (speed > MCI_MAXIMUM_SPEED)
+    {
+        speed = MCI_MAXIMUM_SPEED;
+    }
+    
+    /* interpolate between the two table points around the speed */
+    index = (uint32_t)speed >> MCI_GAIN_SCHEDULE_STEP_SHIFT;
+    fraction = (uint32_t)speed & ((1u << MCI_GAIN_SCHEDULE_STEP_SHIFT) - 1u);
+    kpScale = mci_InterpolateScale(p_row[index].kpScale, 
+        p_row[index + 1u].kpScale, fraction);
+    kdScale = mci_InterpolateScale(p_row[index].kdScale, 
+        p_row[index + 1u].kdScale, fraction);
+    
+    p_gains->kp = sf_Q16Mul(p_baseGains->kp, kpScale);
+    p_gains->ki = sf_Q16Mul(p_baseGains->ki, kpScale);
+    p_gains->kd = sf_Q16Mul(p_baseGains->kd, kdScale);
+}
+
+/**
+* Schedule the gains of a running controller for this control tick
+*
+* \param[in] p_pid Pointer to the controller, state is kept
+* \param[in] manoeuvre Manoeuvre type the controller is running
+* \param[in] speed Commanded speed, sign is ignored
+* \param[in] p_baseGains Gains tuned at MCI_GAIN_SCHEDULE_TUNED_SPEED
+* \retval None
+*/
+void mci_SchedulePid(sf_pid_t *p_pid, mci_manoeuvre_t manoeuvre, 
+    int32_t speed, const mci_pid_gains_t *p_baseGains)
+{
+    mci_pid_gains_t gains;
+    
+    mci_ScheduleGains(manoeuvre, speed, p_baseGains, &gains);
+    sf_SetPidGains(p_pid, gains.kp, gains.ki, gains.kd);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                           Local Shared Functions                           */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                         Private (Static) Functions                         */
+/*----------------------------------------------------------------------------*/
+/**
+* Linearly interpolate between two neighbouring table scales
+*
+* \param[in] lowScale Scale at the lower table point
+* \param[in] highScale Scale at the upper table point
+* \param[in] fraction Speed past the lower table point
+* \retval interpolated scale
+*/
+static sf_q16_t mci_InterpolateScale(sf_q16_t lowScale, sf_q16_t highScale,
+    uint32_t fraction)
+{
+    return lowScale + (((highScale - lowScale) * (int32_t)fraction) >> 
+        MCI_GAIN_SCHEDULE_STEP_SHIFT);
+}
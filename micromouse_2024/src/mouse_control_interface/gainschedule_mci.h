@@ -0,0 +1,46 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : gainschedule_mci.h
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-04-13
+* Purpose         : mouse control interface layer
+*
+* This is the header file for speed dependent gain scheduling under the
+* mouse control interface.
+*
+* Gains in settings are tuned at search speed. Each manoeuvre type has a
+* table of gain scales indexed by commanded speed that adapts them to the
+* speed the mouse is actually moving at.
+*
+* The mouse control interface uses the mouse hardware interface to define high
+* level micromouse functionality.
+*-----------------------------------------------------------------------------*/
+
+#ifndef GAINSCHEDULE_MCI_H_
+#define GAINSCHEDULE_MCI_H_
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+/* gain scale table- speed 0 to 256 in steps of 64 */
+#define MCI_GAIN_SCHEDULE_POINTS        (5u)
+#define MCI_GAIN_SCHEDULE_STEP_SHIFT    (6u)
+
+/* speed the settings gains are tuned at, where every scale is 1.0- the */
+/* autotune relay drives the wheels at this speed */
+#define MCI_GAIN_SCHEDULE_TUNED_SPEED   (80)
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+void mci_ScheduleGains(mci_manoeuvre_t manoeuvre, int32_t speed,
+    const mci_pid_gains_t *p_baseGains, mci_pid_gains_t *p_gains);
+void mci_SchedulePid(sf_pid_t *p_pid, mci_manoeuvre_t manoeuvre, 
+    int32_t speed, const mci_pid_gains_t *p_baseGains);
+
+#endif /* GAINSCHEDULE_MCI_H_ */
@@ -25,6 +25,9 @@
 #include "mouse_hardware_interface/power_mhi.h"
 #include "mouse_hardware_interface/irsensors_mhi.h"
 #include "mouse_hardware_interface/motors_mhi.h"
+#include "mouse_hardware_interface/storage_mhi.h"
+#include "shared_functions/fixedpoint_sf.h"
+#include "mouse_control_interface/settings_mci.h"
 #include "mouse_control_interface/init_mci.h"
 
 /*----------------------------------------------------------------------------*/
@@ -74,6 +77,10 @@ void mci_InitializeMouse(void)
     mhi_InitPwm();
     mhi_InitWheelMotors();
     mhi_InitVacuumMotor();
+    mhi_InitStorage();
+    
+    /* load tuned settings before anything moves */
+    mci_LoadSettings();
     
     /* enable global interrupts */
     mhi_EnableGlobalInterrupts();
@@ -0,0 +1,206 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : ircal_mci.c
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-04-13
+* Purpose         : mouse control interface layer
+*
+* This is the source file for IR sensor calibration under the mouse control
+* interface.
+*
+* The mouse control interface uses the mouse hardware interface to define high
+* level micromouse functionality.
+*-----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include "micromouse_dimensions.h"
+#include "shared_functions/fixedpoint_sf.h"
+#include "mouse_hardware_interface/leds_mhi.h"
+#include "mouse_hardware_interface/usart_mhi.h"
+#include "mouse_hardware_interface/irsensors_mhi.h"
+#include "mouse_control_interface/walldetection_mci.h"
+#include "mouse_control_interface/settings_mci.h"
+#include "mouse_control_interface/configswitch_mci.h"
+#include "mouse_control_interface/time_mci.h"
+#include "mouse_control_interface/ircal_mci.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+/* control ticks averaged per pose */
+#define MCI_IRCAL_SAMPLES               (32u)
+
+/* threshold as eighths of the way from the open to the centered reading */
+#define MCI_IRCAL_FRONT_THRESHOLD_EIGHTHS   (7u)
+#define MCI_IRCAL_SIDE_THRESHOLD_EIGHTHS    (5u)
+
+/* a wall must read at least this much above the open reading */
+#define MCI_IRCAL_MINIMUM_CONTRAST_RAW  MCI_IR_RAW_FROM_10BIT(20u)
+
+/*----------------------------------------------------------------------------*/
+/*                               Debug Switches                               */
+/*----------------------------------------------------------------------------*/
+/* 1 = Enable Debug Trace Output */
+#define DEBUG_MCI_IRCAL_ENABLE    (1)
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                    Private (Static) Function Prototype                     */
+/*----------------------------------------------------------------------------*/
+static void mci_SampleIrPose(uint32_t p_averages[MHI_IR_COUNT]);
+static uint32_t mci_GetIrThreshold(uint32_t openReading, 
+    uint32_t centeredReading, uint32_t eighths, uint16_t *p_threshold);
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+/**
+* Measure IR wall thresholds and centering setpoints at two known poses
+*
+* D1 on: place the mouse centered in a square w/ walls on the left, right
+* and front, then press the button. D2 on: place it centered in a square w/
+* no walls on any of those sides, then press again. Thresholds sit part way
+* from the open reading to the centered reading. The new values are saved
+* to storage on success.
+*
+* \param None
+* \retval MCI_IRCAL_DONE Calibration updated and saved
+* \retval MCI_IRCAL_FAILED A sensor saw no wall, calibration left alone
+*/
+mci_ircal_status_t mci_CalibrateIrSensors(void)
+{
+    mci_ircal_status_t status = MCI_IRCAL_FAILED;
+    mci_ir_calibration_t calibration;
+    uint32_t walls[MHI_IR_COUNT] = {0u};
+    uint32_t open[MHI_IR_COUNT] = {0u};
+    uint32_t frontWall = 0u;
+    uint32_t frontOpen = 0u;
+    uint32_t valid = 1u;
+    
+    /* pose 1- walls on every side but the back */
+    mhi_SetD1Led();
+    while (mci_CheckConfigButtonPressed() == MCI_BUTTON_NOT_PRESSED)
+    {
+    }
+    mci_SampleIrPose(walls);
+    mhi_ClearD1Led();
+    
+    /* pose 2- no walls on any of those sides */
+    mhi_SetD2Led();
+    while (mci_CheckConfigButtonPressed() == MCI_BUTTON_NOT_PRESSED)
+    {
+    }
+    mci_SampleIrPose(open);
+    mhi_ClearD2Led();
+    
+    /* front wall checks use the average of both front sensors */
+    frontWall = (walls[MHI_IR1_INDEX] + walls[MHI_IR4_INDEX]) / 2u;
+    frontOpen = (open[MHI_IR1_INDEX] + open[MHI_IR4_INDEX]) / 2u;
+    
+    calibration.frontCenteredRaw = (uint16_t)frontWall;
+    calibration.leftCenteredRaw = (uint16_t)walls[MHI_IR2_INDEX];
+    calibration.rightCenteredRaw = (uint16_t)walls[MHI_IR3_INDEX];
+    
+    valid &= mci_GetIrThreshold(frontOpen, frontWall, 
+        MCI_IRCAL_FRONT_THRESHOLD_EIGHTHS, &calibration.frontThresholdRaw);
+    valid &= mci_GetIrThreshold(open[MHI_IR2_INDEX], walls[MHI_IR2_INDEX], 
+        MCI_IRCAL_SIDE_THRESHOLD_EIGHTHS, &calibration.leftThresholdRaw);
+    valid &= mci_GetIrThreshold(open[MHI_IR3_INDEX], walls[MHI_IR3_INDEX], 
+        MCI_IRCAL_SIDE_THRESHOLD_EIGHTHS, &calibration.rightThresholdRaw);
+    
+#if defined(DEBUG_MCI_IRCAL_ENABLE) && (DEBUG_MCI_IRCAL_ENABLE == 1)
+    mhi_PrintString("IR cal thresholds: ");
+    mhi_PrintInt(calibration.frontThresholdRaw);
+    mhi_PrintString(" ");
+    mhi_PrintInt(calibration.leftThresholdRaw);
+    mhi_PrintString(" ");
+    mhi_PrintInt(calibration.rightThresholdRaw);
+    mhi_PrintString(" centered: ");
+    mhi_PrintInt(calibration.frontCenteredRaw);
+    mhi_PrintString(" ");
+    mhi_PrintInt(calibration.leftCenteredRaw);
+    mhi_PrintString(" ");
+    mhi_PrintInt(calibration.rightCenteredRaw);
+    mhi_PrintString("\r\n");
+#endif /* DEBUG_MCI_IRCAL_ENABLE */
+    
+    if (valid)
+    {
+        mci_GetSettings()->irCalibration = calibration;
+        mci_SaveSettings();
+        /* new thresholds- sensors flagged under the old ones get a retry */
+        mhi_ResetIrHealth();
+        status = MCI_IRCAL_DONE;
+    }
+    
+    return status;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                           Local Shared Functions                           */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                         Private (Static) Functions                         */
+/*----------------------------------------------------------------------------*/
+/**
+* Average every IR sensor over a number of control ticks
+*
+* \param[out] p_averages Average reading per sensor, see MHI_IR1_INDEX etc.
+* \retval None
+*/
+static void mci_SampleIrPose(uint32_t p_averages[MHI_IR_COUNT])
+{
+    uint32_t readings[MHI_IR_COUNT] = {0u};
+    uint32_t sums[MHI_IR_COUNT] = {0u};
+    uint32_t sample = 0u;
+    uint32_t i = 0u;
+    
+    for (sample = 0u; sample < MCI_IRCAL_SAMPLES; sample++)
+    {
+        mci_WaitForControlTick();
+        mhi_ReadAllIr(readings);
+        for (i = 0u; i < MHI_IR_COUNT; i++)
+        {
+            sums[i] += readings[i];
+        }
+    }
+    
+    for (i = 0u; i < MHI_IR_COUNT; i++)
+    {
+        p_averages[i] = sums[i] / MCI_IRCAL_SAMPLES;
+    }
+}
+
+/**
+* Place a wall threshold between the open and centered readings
+*
+* \param[in] openReading Reading w/ no wall
+* \param[in] centeredReading Reading w/ the mouse centered by a wall
+* \param[in] eighths How far toward the centered reading, in eighths
+* \param[out] p_threshold Threshold, only written when valid
+* \retval 1 Threshold valid
+* \retval 0 Too little difference between the readings
+*/
+static uint32_t mci_GetIrThreshold(uint32_t openReading, 
+    uint32_t centeredReading, uint32_t eighths, uint16_t *p_threshold)
+{
+    if (centeredReading < (openReading + MCI_IRCAL_MINIMUM_CONTRAST_RAW))
+    {
+        return 0u;
+    }
+    
+    *p_threshold = (uint16_t)(openReading + 
+        (((centeredReading - openReading) * eighths) / 8u));
+    
+    return 1u;
+}
@@ -0,0 +1,41 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : ircal_mci.h
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-04-13
+* Purpose         : mouse control interface layer
+*
+* This is the header file for IR sensor calibration under the mouse control
+* interface.
+*
+* Wall thresholds and centering setpoints are measured on the mouse in the
+* maze it is about to run and kept in the stored settings, so a new maze or
+* new lighting only needs a calibration instead of a reflash.
+*
+* The mouse control interface uses the mouse hardware interface to define high
+* level micromouse functionality.
+*-----------------------------------------------------------------------------*/
+
+#ifndef IRCAL_MCI_H_
+#define IRCAL_MCI_H_
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+typedef enum
+{
+    MCI_IRCAL_DONE = 0u,
+    MCI_IRCAL_FAILED
+} mci_ircal_status_t;
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+mci_ircal_status_t mci_CalibrateIrSensors(void);
+
+#endif /* IRCAL_MCI_H_ */
@@ -0,0 +1,290 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : motorcal_mci.c
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-04-13
+* Purpose         : mouse control interface layer
+*
+* This is the source file for wheel motor characterization under the mouse
+* control interface.
+*
+* The mouse control interface uses the mouse hardware interface to define high
+* level micromouse functionality.
+*-----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include "micromouse_dimensions.h"
+#include "shared_functions/fixedpoint_sf.h"
+#include "mouse_hardware_interface/leds_mhi.h"
+#include "mouse_hardware_interface/usart_mhi.h"
+#include "mouse_hardware_interface/motors_mhi.h"
+#include "mouse_hardware_interface/interrupts_mhi.h"
+#include "mouse_control_interface/walldetection_mci.h"
+#include "mouse_control_interface/movement_mci.h"
+#include "mouse_control_interface/odometry_mci.h"
+#include "mouse_control_interface/settings_mci.h"
+#include "mouse_control_interface/time_mci.h"
+#include "mouse_control_interface/motorcal_mci.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+/* duty cycle sweep- 0 to full duty, last step is limited to full duty */
+#define MCI_MOTORCAL_DUTY_STEP          (16u)
+#define MCI_MOTORCAL_SAMPLES            (17u)
+
+/* control ticks to let the wheels reach speed, then to count edges */
+#define MCI_MOTORCAL_SETTLE_TICKS       (25u)
+#define MCI_MOTORCAL_MEASURE_TICKS      (63u)
+
+/*----------------------------------------------------------------------------*/
+/*                               Debug Switches                               */
+/*----------------------------------------------------------------------------*/
+/* 1 = Enable Debug Trace Output */
+#define DEBUG_MCI_MOTORCAL_ENABLE    (1)
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                    Private (Static) Function Prototype                     */
+/*----------------------------------------------------------------------------*/
+static uint16_t mci_GetSweepDuty(uint32_t sample);
+static void mci_BuildWheelTable(const uint32_t *p_edges, uint32_t topEdges,
+    mci_wheel_table_t *p_table);
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+/**
+* Sweep wheel motor duty cycles and build each wheel's duty cycle table
+*
+* Run w/ the wheels off the ground- both wheels spin forward up to full
+* duty. The new tables are saved to storage on success.
+*
+* \param None
+* \retval MCI_MOTORCAL_DONE Tables updated and saved
+* \retval MCI_MOTORCAL_FAILED A wheel never turned, tables left alone
+*/
+mci_motorcal_status_t mci_CharacterizeWheelMotors(void)
+{
+    mci_motorcal_status_t status = MCI_MOTORCAL_FAILED;
+    uint32_t leftEdges[MCI_MOTORCAL_SAMPLES];
+    uint32_t rightEdges[MCI_MOTORCAL_SAMPLES];
+    uint32_t topEdges = 0u;
+    uint32_t sample = 0u;
+    uint32_t tick = 0u;
+    
+    mhi_SetD2Led();
+    mhi_StartWheelMotor1Forward();
+    mhi_StartWheelMotor2Forward();
+    
+    for (sample = 0u; sample < MCI_MOTORCAL_SAMPLES; sample++)
+    {
+        mhi_SetWheelSpeeds((int16_t)mci_GetSweepDuty(sample), 
+            (int16_t)mci_GetSweepDuty(sample));
+        
+        for (tick = 0u; tick < MCI_MOTORCAL_SETTLE_TICKS; tick++)
+        {
+            mci_WaitForControlTick();
+        }
+        
+        mhi_ClearEncoder1EdgeCount();
+        mhi_ClearEncoder2EdgeCount();
+        for (tick = 0u; tick < MCI_MOTORCAL_MEASURE_TICKS; tick++)
+        {
+            mci_WaitForControlTick();
+        }
+        leftEdges[sample] = mhi_GetEncoder1EdgeCount();
+        rightEdges[sample] = mhi_GetEncoder2EdgeCount();
+        
+#if defined(DEBUG_MCI_MOTORCAL_ENABLE) && (DEBUG_MCI_MOTORCAL_ENABLE == 1)
+        mhi_PrintString("duty: ");
+        mhi_PrintInt(mci_GetSweepDuty(sample));
+        mhi_PrintString(" edges: ");
+        mhi_PrintInt(leftEdges[sample]);
+        mhi_PrintString(" ");
+        mhi_PrintInt(rightEdges[sample]);
+        mhi_PrintString("\r\n");
+#endif /* DEBUG_MCI_MOTORCAL_ENABLE */
+    }
+    
+    mhi_StopWheelMotor1();
+    mhi_StopWheelMotor2();
+    mhi_ClearEncoder1EdgeCount();
+    mhi_ClearEncoder2EdgeCount();
+    
+    /* the wheels did not go anywhere */
+    mci_ClearEncoderCounts();
+    mci_ResetPose();
+    
+    /* full speed is what the slower wheel can reach */
+    topEdges = leftEdges[MCI_MOTORCAL_SAMPLES - 1u];
+    if (rightEdges[MCI_MOTORCAL_SAMPLES - 1u] < topEdges)
+    {
+        topEdges = rightEdges[MCI_MOTORCAL_SAMPLES - 1u];
+    }
+    
+    if (topEdges > 0u)
+    {
+        mci_BuildWheelTable(leftEdges, topEdges, 
+            &mci_GetSettings()->leftWheelTable);
+        mci_BuildWheelTable(rightEdges, topEdges, 
+            &mci_GetSettings()->rightWheelTable);
+        mci_SaveSettings();
+        status = MCI_MOTORCAL_DONE;
+    }
+    
+    mhi_ClearD2Led();
+    
+    return status;
+}
+
+/**
+* Convert a linear wheel speed to the duty cycle that wheel needs
+*
+* \param[in] wheel Wheel to convert for
+* \param[in] speed Wheel speed from 0 to 255, 255 is top common speed
+* \retval duty cycle for mhi_SetWheelMotorXSpeed()
+*/
+uint16_t mci_ConvertSpeedToDuty(mci_wheel_t wheel, uint32_t speed)
+{
+    const mci_settings_t *p_settings = mci_GetSettings();
+    const mci_wheel_table_t *p_table = &p_settings->leftWheelTable;
+    uint32_t index = 0u;
+    uint32_t fraction = 0u;
+    int32_t duty = 0;
+    
+    if (wheel == MCI_WHEEL_RIGHT)
+    {
+        p_table = &p_settings->rightWheelTable;
+    }
+    
+    /* no deadband offset when stopped */
+    if (speed == 0u)
+    {
+        return 0u;
+    }
+    
+    if (speed > (uint32_t)MCI_MAXIMUM_SPEED)
+    {
+        speed = (uint32_t)MCI_MAXIMUM_SPEED;
+    }
+    
+    /* interpolate between the two table points around the speed */
+    index = speed >> MCI_WHEEL_TABLE_STEP_SHIFT;
+    fraction = speed & ((1u << MCI_WHEEL_TABLE_STEP_SHIFT) - 1u);
+    duty = (int32_t)p_table->duty[index] + 
+        ((((int32_t)p_table->duty[index + 1u] - 
+        (int32_t)p_table->duty[index]) * (int32_t)fraction) >> 
+        MCI_WHEEL_TABLE_STEP_SHIFT);
+    
+    if (duty > MCI_MAXIMUM_SPEED)
+    {
+        duty = MCI_MAXIMUM_SPEED;
+    }
+    
+    return (uint16_t)duty;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                           Local Shared Functions                           */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                         Private (Static) Functions                         */
+/*----------------------------------------------------------------------------*/
+/**
+* Get the duty cycle used for one sweep sample
+*
+* \param[in] sample Sweep sample index
+* \retval duty cycle
+*/
+static uint16_t mci_GetSweepDuty(uint32_t sample)
+{
+    uint32_t duty = sample * MCI_MOTORCAL_DUTY_STEP;
+    
+    if (duty > (uint32_t)MCI_MAXIMUM_SPEED)
+    {
+        duty = (uint32_t)MCI_MAXIMUM_SPEED;
+    }
+    
+    return (uint16_t)duty;
+}
+
+/**
+* Build a wheel's duty cycle table by inverting its measured speed curve
+*
+* Measured speeds are made monotonic first so a noisy sample cannot fold
+* the curve back. The first table point is the highest duty cycle before
+* the wheel started to turn.
+*
+* \param[in] p_edges Edges counted at each sweep sample
+* \param[in] topEdges Edges counted at top common speed
+* \param[out] p_table Table to fill
+* \retval None
+*/
+static void mci_BuildWheelTable(const uint32_t *p_edges, uint32_t topEdges,
+    mci_wheel_table_t *p_table)
+{
+    uint32_t monotonic[MCI_MOTORCAL_SAMPLES];
+    uint32_t targetEdges = 0u;
+    uint32_t sample = 0u;
+    uint32_t point = 0u;
+    
+    monotonic[0] = p_edges[0];
+    for (sample = 1u; sample < MCI_MOTORCAL_SAMPLES; sample++)
+    {
+        monotonic[sample] = (p_edges[sample] > monotonic[sample - 1u]) ? 
+            p_edges[sample] : monotonic[sample - 1u];
+    }
+    
+    /* deadband- last duty cycle that did not move the wheel */
+    p_table->duty[0] = 0u;
+    for (sample = 0u; (sample < MCI_MOTORCAL_SAMPLES) && 
+        (monotonic[sample] == 0u); sample++)
+    {
+        p_table->duty[0] = mci_GetSweepDuty(sample);
+    }
+    
+    for (point = 1u; point < MCI_WHEEL_TABLE_POINTS; point++)
+    {
+        targetEdges = (topEdges * point) / (MCI_WHEEL_TABLE_POINTS - 1u);
+        
+        /* first sample at or above the target, always found at top speed */
+        for (sample = 1u; (sample < (MCI_MOTORCAL_SAMPLES - 1u)) && 
+            (monotonic[sample] < targetEdges); sample++)
+        {
+        }
+        
+        if (targetEdges <= monotonic[sample - 1u])
+        {
+            p_table->duty[point] = mci_GetSweepDuty(sample - 1u);
+        }
+        else if (monotonic[sample] <= targetEdges)
+        {
+            p_table->duty[point] = mci_GetSweepDuty(sample);
+        }
+        else
+        {
+            p_table->duty[point] = (uint16_t)(mci_GetSweepDuty(sample - 1u) + 
+                (((uint32_t)(mci_GetSweepDuty(sample) - 
+                mci_GetSweepDuty(sample - 1u)) * 
+                (targetEdges - monotonic[sample - 1u])) / 
+                (monotonic[sample] - monotonic[sample - 1u])));
+        }
+        
+        /* keep the table from dipping below the deadband */
+        if (p_table->duty[point] < p_table->duty[point - 1u])
+        {
+            p_table->duty[point] = p_table->duty[point - 1u];
+        }
+    }
+}
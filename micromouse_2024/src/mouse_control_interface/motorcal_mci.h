@@ -0,0 +1,48 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : motorcal_mci.h
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-04-13
+* Purpose         : mouse control interface layer
+*
+* This is the header file for wheel motor characterization under the mouse
+* control interface.
+*
+* Wheel speeds given to the control loops are linear in actual wheel speed-
+* 255 is the top speed both wheels can reach. Each wheel's duty cycle table
+* removes the motor deadband and the difference between the two motors.
+*
+* The mouse control interface uses the mouse hardware interface to define high
+* level micromouse functionality.
+*-----------------------------------------------------------------------------*/
+
+#ifndef MOTORCAL_MCI_H_
+#define MOTORCAL_MCI_H_
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+typedef enum
+{
+    MCI_WHEEL_LEFT = 0u,    /* motor 1 */
+    MCI_WHEEL_RIGHT         /* motor 2 */
+} mci_wheel_t;
+
+typedef enum
+{
+    MCI_MOTORCAL_DONE = 0u,
+    MCI_MOTORCAL_FAILED
+} mci_motorcal_status_t;
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+mci_motorcal_status_t mci_CharacterizeWheelMotors(void);
+uint16_t mci_ConvertSpeedToDuty(mci_wheel_t wheel, uint32_t speed);
+
+#endif /* MOTORCAL_MCI_H_ */
@@ -21,19 +21,137 @@
 #include <math.h>
 #include "micromouse_dimensions.h"
 #include "shared_functions/constrain_sf.h"
+#include "shared_functions/fixedpoint_sf.h"
 #include "mouse_hardware_interface/leds_mhi.h"
 #include "mouse_hardware_interface/usart_mhi.h"
 #include "mouse_hardware_interface/irsensors_mhi.h"
 #include "mouse_control_interface/walldetection_mci.h"
 #include "mouse_hardware_interface/motors_mhi.h"
 #include "mouse_hardware_interface/interrupts_mhi.h"
-#include "mouse_control_interface/movement_mci.h"
 #include "mouse_control_interface/walldetection_mci.h"
+#include "mouse_control_interface/movement_mci.h"
+#include "mouse_control_interface/odometry_mci.h"
+#include "mouse_control_interface/settings_mci.h"
+#include "mouse_control_interface/motorcal_mci.h"
+#include "mouse_control_interface/time_mci.h"
+#include "mouse_control_interface/vacuum_mci.h"
+#include "mouse_control_interface/stall_mci.h"
+#include "mouse_control_interface/gainschedule_mci.h"
 
 /*----------------------------------------------------------------------------*/
 /*                                Definitions                                 */
 /*----------------------------------------------------------------------------*/
-/* None */
+/* in place turn convergence- tolerance in edges of wheel difference */
+#define MCI_TURN_TOLERANCE_EDGES    (1)
+#define MCI_TURN_SETTLE_TICKS       (3u)
+/* turn time allowed per started quarter turn */
+#define MCI_TURN_TIMEOUT_MS_PER_90_DEGREES    (600u)
+
+/* straight move acceleration limits in speed per control tick- the limit is
+   halved on wheel slip and creeps back up after each slip free move */
+#define MCI_MOVE_ACCELERATION_MAXIMUM     (24)
+#define MCI_MOVE_ACCELERATION_MINIMUM     (3)
+#define MCI_MOVE_ACCELERATION_RECOVERY    (2)
+/* fan suction raises the traction limit */
+#define MCI_MOVE_ACCELERATION_MAXIMUM_DOWNFORCE    (40)
+
+/* each side wall heading sample closes 1/N of its gap to encoder heading */
+#define MCI_MOVE_WALL_HEADING_BLEND_DIVISOR    (2)
+
+/* single wall centering weights */
+#define MCI_MOVE_SINGLE_WALL_FAR_GAIN           (5)
+#define MCI_MOVE_SINGLE_WALL_GAIN               (2)
+
+/* front wall alignment PD gains on raw front sensor readings */
+/* (tuned per 10 bit count, divided down to the reading width). The gains */
+/* set how fast alignment settles, the timeout only catches a stuck loop */
+#define MCI_ALIGN_KP_ANGLE \
+    (SF_Q16_FROM_FLOAT(3.0f) / (int32_t)MCI_IR_RAW_FROM_10BIT(1u))
+#define MCI_ALIGN_KD_ANGLE \
+    (SF_Q16_FROM_FLOAT(1.0f) / (int32_t)MCI_IR_RAW_FROM_10BIT(1u))
+#define MCI_ALIGN_KP_DISTANCE \
+    (SF_Q16_FROM_FLOAT(2.5f) / (int32_t)MCI_IR_RAW_FROM_10BIT(1u))
+#define MCI_ALIGN_KD_DISTANCE \
+    (SF_Q16_FROM_FLOAT(0.5f) / (int32_t)MCI_IR_RAW_FROM_10BIT(1u))
+
+/* front wall alignment speed limit- the wheel tables handle the deadband */
+#define MCI_ALIGN_MAXIMUM_SPEED     (150)
+
+/* front wall alignment convergence- tolerances in raw sensor counts */
+#define MCI_ALIGN_ANGLE_TOLERANCE       ((int32_t)MCI_IR_RAW_FROM_10BIT(6u))
+#define MCI_ALIGN_DISTANCE_TOLERANCE    ((int32_t)MCI_IR_RAW_FROM_10BIT(6u))
+#define MCI_ALIGN_SETTLE_TICKS          (2u)
+#define MCI_ALIGN_TIMEOUT_MS            (400u)
+
+/* front wall approach- straights that may end at a front wall hand the
+   stop over to distance regulation once the wall stays in sensor range,
+   and take it back if the wall falls out of range again */
+#define MCI_APPROACH_IN_RANGE_RAW       MCI_IR_RAW_FROM_10BIT(40u)
+#define MCI_APPROACH_OUT_OF_RANGE_RAW   MCI_IR_RAW_FROM_10BIT(30u)
+#define MCI_APPROACH_IN_RANGE_TICKS     (3u)
+/* hard limit past the target while approaching, in summed wheel edges */
+#define MCI_APPROACH_OVERRUN_EDGES \
+    (2 * (MCI_WHEEL_MOTOR_EDGES_PER_MAZE_SQUARE / 4))
+#define MCI_APPROACH_KP_DISTANCE        SF_Q16_FROM_FLOAT(2.5f)
+#define MCI_APPROACH_CRAWL_SPEED        (60)
+#define MCI_APPROACH_TOLERANCE_MM       (3)
+#define MCI_APPROACH_SETTLE_TICKS       (2u)
+#define MCI_APPROACH_TIMEOUT_TICKS      (125u)
+
+/* straight move speed w/ an IR sensor failed, percent of the profile */
+#define MCI_MOVE_DEGRADED_SPEED_PERCENT    (60)
+
+/* side wall evidence window- part of the last square of a straight whose
+   readings vote on its side walls, in edges from the start of that square.
+   Tune w/ mci_PrintWallPresence() so the window sees whole walls only */
+#define MCI_WALL_EVIDENCE_WINDOW_START_EDGES \
+    (MCI_WHEEL_MOTOR_EDGES_PER_MAZE_SQUARE / 8)
+#define MCI_WALL_EVIDENCE_WINDOW_END_EDGES \
+    (MCI_WHEEL_MOTOR_EDGES_PER_MAZE_SQUARE / 2)
+
+/* back wall recalibration- reverse slowly until the wheels stop turning */
+#define MCI_BACKUP_SPEED                (80)
+#define MCI_BACKUP_CONTACT_TICKS        (12u)
+/* current limit trips on the start up inrush- ignored for these ticks */
+#define MCI_BACKUP_INRUSH_TICKS         (6u)
+#define MCI_BACKUP_MAXIMUM_EDGES        (MCI_WHEEL_MOTOR_EDGES_PER_MAZE_SQUARE)
+#define MCI_BACKUP_TIMEOUT_MS           (1500u)
+/* mouse center behind the square center w/ its back against the wall */
+#define MCI_BACKUP_CONTACT_OFFSET_MM \
+    (((MCI_MAZE_SQUARE_LENGTH_MM / 2) - (MCI_MAZE_PILLAR_WIDTH_MM / 2)) - \
+    (MCI_MOUSE_LENGTH_MM / 2))
+/* contact only counts once the mouse has reversed this far, so a wheel */
+/* that never breaks away does not find the wall at the square center */
+#define MCI_BACKUP_MINIMUM_TRAVEL_MM    (MCI_BACKUP_CONTACT_OFFSET_MM / 2)
+#define MCI_BACKUP_PULL_FORWARD_SPEED   (100)
+
+/* where a side sensor sees a post edge, ahead of the square center */
+#define MCI_WALL_EDGE_WALL_TO_GAP_OFFSET_MM \
+    (((MCI_MAZE_SQUARE_LENGTH_MM / 2) + (MCI_MAZE_PILLAR_WIDTH_MM / 2)) - \
+    MCI_SIDE_SENSOR_LOOKAHEAD_MM)
+#define MCI_WALL_EDGE_GAP_TO_WALL_OFFSET_MM \
+    (((MCI_MAZE_SQUARE_LENGTH_MM / 2) - (MCI_MAZE_PILLAR_WIDTH_MM / 2)) - \
+    MCI_SIDE_SENSOR_LOOKAHEAD_MM)
+/* ignore edges further than this from where odometry expects them */
+#define MCI_WALL_EDGE_SNAP_TOLERANCE_MM    (30)
+
+/* straight move state kept between polls */
+typedef struct
+{
+    mci_move_params_t params;
+    mci_move_status_t status;
+    int32_t targetPosition;     /* edges summed over both wheels */
+    int32_t position;
+    int32_t baseSpeed;
+    int32_t headingCorrection;  /* wall heading fix to the edge difference */
+    uint32_t approachingWall;   /* stop handed over to front wall distance */
+    uint32_t approachInRangeTicks;
+    uint32_t approachTicks;
+    uint32_t approachSettledTicks;
+    uint32_t slipSeen;
+    sf_pid_t encoderPid;
+    sf_pid_t sensorPid;
+} mci_move_state_t;
 
 /*----------------------------------------------------------------------------*/
 /*                               Debug Switches                               */
@@ -44,12 +162,39 @@
 /*----------------------------------------------------------------------------*/
 /*                              Global Variables                              */
 /*----------------------------------------------------------------------------*/
-/* None */
+/* straight move acceleration limit, lowered while the wheels slip */
+static int32_t accelerationLimit = MCI_MOVE_ACCELERATION_MAXIMUM;
+/* downforce state the acceleration limit was last set up for */
+static mci_downforce_t accelerationDownforce = MCI_DOWNFORCE_OFF;
+
+/* in place turn profiles w/o and w/ fan suction */
+static const mci_turn_profile_t searchTurnProfile = MCI_TURN_PROFILE_SEARCH;
+static const mci_turn_profile_t downforceTurnProfile = 
+    MCI_TURN_PROFILE_DOWNFORCE;
+
+/* straight move in progress */
+static mci_move_state_t activeMove = {.status = MCI_MOVE_DONE};
+
+/* last wheel speeds given to mci_DriveWheels(), for stall detection */
+static int32_t drivenLeftSpeed = 0;
+static int32_t drivenRightSpeed = 0;
 
 /*----------------------------------------------------------------------------*/
 /*                    Private (Static) Function Prototype                     */
 /*----------------------------------------------------------------------------*/
-/* None */
+static int32_t mci_GetAccelerationMaximum(void);
+static void mci_FinishMove(void);
+static void mci_CorrectPositionAtWallEdge(mci_wall_edge_t edge, 
+    int32_t *p_targetPosition);
+static uint32_t mci_GetCenteringError(mci_centering_policy_t policy, 
+    mci_wall_presence_t leftWall, mci_wall_presence_t rightWall,
+    uint32_t leftReading, uint32_t rightReading, int32_t *p_error);
+static void mci_UpdateFrontWallApproach(uint32_t ir1Reading, 
+    uint32_t ir4Reading);
+static mci_move_status_t mci_ApproachFrontWall(uint32_t ir1Reading, 
+    uint32_t ir4Reading);
+static int32_t mci_GetLastSquareStart(void);
+static uint32_t mci_IsInWallEvidenceWindow(void);
 
 /*----------------------------------------------------------------------------*/
 /*                       Public (Exportable) Functions                        */
@@ -68,8 +213,7 @@ void mci_MoveForward1Revolution(void)
     uint32_t leftDone = 0u;
     
     /* reset encoder counts */
-    mhi_ClearEncoder1EdgeCount();
-    mhi_ClearEncoder2EdgeCount();
+    mci_ClearEncoderCounts();
     
     /* set speed and start in forward direction */
     mhi_SetWheelMotor1Speed(MCI_MINIMUM_SPEED);
@@ -80,6 +224,7 @@ void mci_MoveForward1Revolution(void)
     /* keep moving motors until encoder edge counts are reached */
     while((!rightDone) || (!leftDone))
     {
+        mci_UpdateOdometry();
         /* right motor */
         if ((!rightDone) && (mhi_GetEncoder1EdgeCount() >= MCI_WHEEL_MOTOR_EDGES_PER_REVOLUTION))
         {
@@ -124,8 +269,7 @@ void mci_MoveForward1Revolution(void)
     mhi_PrintString("\r\n");
     
     /* clear encoder edge counts and set motor speeds to 0 */
-    mhi_ClearEncoder1EdgeCount();
-    mhi_ClearEncoder2EdgeCount();
+    mci_ClearEncoderCounts();
     mhi_SetWheelMotor1Speed(0);
     mhi_SetWheelMotor2Speed(0);
 }
@@ -139,434 +283,330 @@ void mci_MoveForward1Revolution(void)
 */
 void mci_MoveForward1MazeSquarePid(void)
 {
-    /* initialize encoder PID constants (integral term not needed) */
-    float kp = 2;      /* proportional term */
-    float kd = 0.2;    /* derivative term */
-    
-    /* initialize sensor PD constants */
-    float kpSensor = 0.1;
-    float kdSensor = 0.01;
-    
-    /* initialize left sensor PD constants */
-    float kpSensorL = 0.1; // was 5
-    float kdSensorL = 0.01;
-    
-    /* initialize right sensor PD constants */
-    float kpSensorR = 0.1; // was 5
-    float kdSensorR = 0.01;
-    
-    /* other encoder PID variables */
-    int32_t initialPosition = mhi_GetEncoder1EdgeCount() + mhi_GetEncoder2EdgeCount();
-    int32_t targetPosition = initialPosition + (MCI_WHEEL_MOTOR_EDGES_PER_MAZE_SQUARE * 2);
-    int32_t targetAngle = 0;
-    int32_t prevError = 0;
-    float error = 0;
-    float dError = 0;
-    
-    /* other sensor PD variables */
-    int32_t output = 0;
-    int32_t outputSensors = 0;
-    int32_t prevErrorSensors = 0;
-    int32_t errorSensors = 0;
-    int32_t dErrorSensors = 0;
-    
-    /* other left sensor PD variables */
-    int32_t errorSensorLeft = 0;
-    
-    /* other right sensor PD variables */
-    int32_t errorSensorRight = 0;
-    
-    /* new motor speeds provided all PDs */
-    int32_t newLeftSpeed = 0;
-    int32_t newRightSpeed = 0;
-    
-    /* IR sensor variables */
-    uint32_t ir2Reading = 0u;
-    uint32_t ir3Reading = 0u;
+    mci_StartMoveForward1MazeSquarePid();
     
-    /* local wall presence variables */
-    mci_wall_presence_t leftWall = MCI_CANNOT_READ_WALL;
-    mci_wall_presence_t rightWall = MCI_CANNOT_READ_WALL;
+    while (mci_PollMove() == MCI_MOVE_RUNNING)
+    {
+        /* wait for the move to end */
+    }
+}
+
+/**
+* Start moving mouse 1 maze square forward using PID w/o waiting
+*
+* \param None
+* \retval None
+*/
+void mci_StartMoveForward1MazeSquarePid(void)
+{
+    mci_move_params_t moveParams =
+    {
+        .distanceEdges = MCI_WHEEL_MOTOR_EDGES_PER_MAZE_SQUARE,
+        .manoeuvre = MCI_MANOEUVRE_STRAIGHT,
+        .profile =
+        {
+            .cruiseSpeed = MCI_FORWARD_FAST_SPEED,
+            .endSpeed = MCI_MINIMUM_SPEED,
+            .decelEdges = 0
+        },
+        .centering = MCI_CENTERING_ALL_WALLS,
+        .stopCondition = MCI_STOP_AT_DISTANCE_OR_FRONT_WALL,
+        .wallUpdates = MCI_WALL_UPDATE_AVAILABLE,
+        .edgeCorrection = MCI_EDGE_CORRECTION_ON
+    };
     
-    /* configure both motors to move forward at base speed */
-    mhi_SetWheelMotor1Speed(MCI_FORWARD_FAST_SPEED);
-    mhi_SetWheelMotor2Speed(MCI_FORWARD_FAST_SPEED);
-    mhi_StartWheelMotor1Forward();
-    mhi_StartWheelMotor2Forward();
+    mci_StartMove(&moveParams);
+}
+
+
+/**
+* Rotate mouse 90 degrees right
+*
+* \param None
+* \retval None
+*/
+void mci_TurnRight90Degrees(void)
+{
+    (void)mci_TurnByAngle(90, mci_GetTurnProfile());
+}
+
+/**
+* Rotate mouse 90 degrees left
+*
+* \param None
+* \retval None
+*/
+void mci_TurnLeft90Degrees(void)
+{
+    (void)mci_TurnByAngle(-90, mci_GetTurnProfile());
+}
+
+/**
+* Align mouse to the front wall in both angle and distance
+*
+* Front sensor difference gives the angle error and their average gives the
+* distance error to the centered reading. Once both settle inside tolerance
+* the mouse is square to the wall at the center of its square, so the pose
+* heading and position along the heading are snapped to match.
+*
+* \param None
+* \retval MCI_MOVE_DONE Aligned, pose snapped
+* \retval MCI_MOVE_TIMEOUT Did not settle in time, pose left alone
+* \retval MCI_MOVE_STALLED Wheels blocked, pose left alone
+*/
+mci_move_status_t mci_AdjustToFrontWall(void)
+{
+    mci_move_status_t status = MCI_MOVE_TIMEOUT;
+    uint32_t elapsedMs = 0u;
+    uint32_t settledTicks = 0u;
+    int32_t ir1Reading = 0;
+    int32_t ir4Reading = 0;
+    uint32_t irReadings[MHI_IR_COUNT] = {0u};
+    uint32_t failed = 0u;
+    int32_t angleError = 0;
+    int32_t distanceError = 0;
+    int32_t forward = 0;
+    int32_t rotate = 0;
+    sf_pid_t anglePid;
+    sf_pid_t distancePid;
     
-    /* allow wall updates on start */
-    mci_SetLeftWallUpdateAvailable();
-    mci_SetRightWallUpdateAvailable();
+    /* nothing to align to w/o a front sensor */
+    if ((mci_GetFailedIrSensors() & MCI_IR_FAILED_FRONT_PAIR) == 
+        MCI_IR_FAILED_FRONT_PAIR)
+    {
+        return MCI_MOVE_TIMEOUT;
+    }
     
-    /* set up target and initial position */
-    mhi_ClearEncoder1EdgeCount();
-    mhi_ClearEncoder2EdgeCount();
-    initialPosition = mhi_GetEncoder1EdgeCount() + mhi_GetEncoder2EdgeCount();
-    targetPosition = initialPosition + (MCI_WHEEL_MOTOR_EDGES_PER_MAZE_SQUARE * 2);
+    sf_InitPid(&anglePid, MCI_ALIGN_KP_ANGLE, 0, MCI_ALIGN_KD_ANGLE,
+        -MCI_ALIGN_MAXIMUM_SPEED, MCI_ALIGN_MAXIMUM_SPEED);
+    sf_InitPid(&distancePid, MCI_ALIGN_KP_DISTANCE, 0, MCI_ALIGN_KD_DISTANCE,
+        -MCI_ALIGN_MAXIMUM_SPEED, MCI_ALIGN_MAXIMUM_SPEED);
     
+    mci_ResetStallMonitor();
+    drivenLeftSpeed = 0;
+    drivenRightSpeed = 0;
     
-    /* main control loop */
-    while ((mhi_GetEncoder1EdgeCount() + mhi_GetEncoder2EdgeCount()) < targetPosition)
+    while (elapsedMs < MCI_ALIGN_TIMEOUT_MS)
     {
-        /* stop if there's a wall in front */
-        if (((mhi_ReadIr1() + mhi_ReadIr4()) / 2) >= MCI_FRONT_WALL_TOO_CLOSE_THRESHOLD_RAW_30MM_HARD_CODED)
-        {
-            break;
-        }
+        mci_WaitForControlTick();
+        mci_UpdateOdometry();
+        elapsedMs += MCI_CONTROL_TICK_MS;
         
-        /* prevent wall updates if moved more than 50% */
-        if ( (mhi_GetEncoder1EdgeCount() + mhi_GetEncoder2EdgeCount()) > ((uint32_t)(targetPosition / 2)) )
+        if (mci_CheckStall(drivenLeftSpeed, drivenRightSpeed) != 
+            MCI_STALL_NONE)
         {
-            mci_SetLeftWallUpdateUnavailable();
-            mci_SetRightWallUpdateUnavailable();
+            status = MCI_MOVE_STALLED;
+            break;
         }
         
-        /* try to update global wall presences- no need to save return value */
-        mci_CheckLeftWall();
-        mci_CheckRightWall();
-        
-        /* check for walls for PID move forward */
-        leftWall = mci_CheckLeftWallMoveForwardPid();
-        rightWall = mci_CheckRightWallMoveForwardPid();
+        /* left front reading higher means the mouse points right of square */
+        /* w/ one front sensor failed only the distance is aligned */
+        failed = mci_ReadHealthyIr(irReadings);
+        ir1Reading = (int32_t)irReadings[MHI_IR1_INDEX];
+        ir4Reading = (int32_t)irReadings[MHI_IR4_INDEX];
+        angleError = ir1Reading - ir4Reading;
+        distanceError = (int32_t)MCI_FRONT_WALL_CENTERED_RAW - 
+            ((ir1Reading + ir4Reading) / 2);
         
-        //output error sensors
-        if ((leftWall == MCI_WALL_FOUND) && (rightWall == MCI_WALL_FOUND))
-        {   
-            mhi_ClearD2Led();
-            mhi_ClearD3Led();
-            mhi_SetD1Led();
-            
-            /* read left wall sensor */
-            ir2Reading = mhi_ReadIr2();
-            
-            /* read right wall sensor */
-            ir3Reading = mhi_ReadIr3();
-            
-            // Error with the sensors
-            errorSensorLeft =  MCI_LEFT_SENSOR_READING_THRESHOLD_RAW - ir2Reading;
-            errorSensorRight = MCI_RIGHT_SENSOR_READING_THRESHOLD_RAW - ir3Reading;
-            errorSensors =  errorSensorRight - errorSensorLeft;
-            dErrorSensors = errorSensors - prevErrorSensors;
-            
-            // Current way of trying to add a pid controller to the mouse using the sensors going to aggregate with the other output
-            outputSensors = (kpSensor * errorSensors) + (kdSensor * dErrorSensors);
-            
-            prevErrorSensors = errorSensors;
-        }
-        
-        else if ((leftWall == MCI_WALL_FOUND) && (rightWall != MCI_WALL_FOUND)) 
-        {   
-            mhi_ClearD1Led();
-            mhi_ClearD3Led();
-            mhi_SetD2Led();
-            
-            //Read left one
-            ir2Reading = mhi_ReadIr2();
-             
-            //error with just left sensor
-            errorSensorLeft = (MCI_LEFT_SENSOR_READING_THRESHOLD_RAW+60) - ir2Reading;//gets larger as closer so if 100-81 means we close to left wall negative we push
-            if(errorSensorLeft>0){
- 			errorSensorLeft*=5;
-	 		}
-			errorSensors = -errorSensorLeft * 2;
-			if(errorSensors<0){
-				mhi_PrintString("ir2: ");
-				mhi_PrintInt((uint32_t)ir2Reading);
-				mhi_PrintString("\t");
-				mhi_PrintString("errorSensors: -");
-				mhi_PrintInt((uint32_t)abs(errorSensors));
-				mhi_PrintString("\r\n");
-			}
-			else{
-				mhi_PrintString("ir2: ");
-				mhi_PrintInt((uint32_t)ir2Reading);
-				mhi_PrintString("\t");
-				mhi_PrintString("errorSensors: ");
-				mhi_PrintInt((uint32_t)abs(errorSensors));
-				mhi_PrintString("\r\n");
-			}
-            dErrorSensors = errorSensors - prevErrorSensors;
-            outputSensors = (kpSensorL * errorSensors) + (kdSensorL * dErrorSensors);
-            // 			 if(targetAngle - (g_sbu_mm_Motor1EncoderEdgeCount - g_sbu_mm_Motor2EncoderEdgeCount) < -45){
-            // 				outputSensors*=-1;
-            // 			 }
-            prevErrorSensors = errorSensors;
-        }
-         
-        else if ((rightWall == MCI_WALL_FOUND) && (leftWall != MCI_WALL_FOUND))
+        /* hold each axis still once it is inside tolerance */
+        if (abs(angleError) <= MCI_ALIGN_ANGLE_TOLERANCE)
         {
-            mhi_ClearD1Led();
-            mhi_ClearD2Led();
-            mhi_SetD3Led();
-            
-            //Read Right one
-            ir3Reading = mhi_ReadIr3();
-             
-            errorSensorRight = (MCI_RIGHT_SENSOR_READING_THRESHOLD_RAW+60) - ir3Reading; //if negative means close to right wall we push
- 			if(errorSensorRight>0){
- 				errorSensorRight*=5;
- 			}
-            errorSensors = errorSensorRight * 3;
-			if(errorSensors<0){
- 				mhi_PrintString("ir3: ");
- 				mhi_PrintInt((uint32_t)ir3Reading);
- 				mhi_PrintString("\t");
- 				mhi_PrintString("errorSensors: -");
- 				mhi_PrintInt((uint32_t)abs(errorSensors));
- 				mhi_PrintString("\r\n");	
-			}
-			else{
- 				mhi_PrintString("ir3: ");
- 				mhi_PrintInt((uint32_t)ir3Reading);
- 				mhi_PrintString("\t");
- 				mhi_PrintString("errorSensors: ");
- 				mhi_PrintInt((uint32_t)abs(errorSensors));
- 				mhi_PrintString("\r\n");
-			}
-			
-            //errorSensors = errorSensorRight;
-            dErrorSensors = errorSensors - prevErrorSensors;
-			
-            outputSensors = (kpSensorR * errorSensors) + (kdSensorR * dErrorSensors);
-            // 			  if(targetAngle - (g_sbu_mm_Motor1EncoderEdgeCount - g_sbu_mm_Motor2EncoderEdgeCount) < 45){
-            // 				  outputSensors*=-1;
-            // 			  }
-            prevErrorSensors = errorSensors;
-// 			if(outputSensors < 0)
-// 				mhi_PrintString("OutputSensors: -");
-// 			else
-// 				mhi_PrintString("OutputSensors: ");
-// 			mhi_PrintInt(abs(outputSensors));
+            rotate = 0;
+            sf_ResetPid(&anglePid);
         }
-        
-        else 
+        else
         {
-            outputSensors = 0;
-            prevErrorSensors = 0;
+            /* positive rotate turns the mouse left */
+            rotate = sf_UpdatePid(&anglePid, angleError);
         }
         
-        /* calculate error (for proportional term) */
-        error = targetAngle - ((int32_t)mhi_GetEncoder1EdgeCount() - (int32_t)mhi_GetEncoder2EdgeCount());
-        
-        /* calculate difference in error (for the derivative term) */
-		error += outputSensors;
-        dError = error - prevError;
-        prevError = error;
-        
-        /* calculate PID output */
-        output = (kp * error) + (kd * dError);
-        
-        /* calculate new speeds */
-        newLeftSpeed = sf_constrain(MCI_MINIMUM_SPEED + output, 255, -255);
-        newRightSpeed = sf_constrain(MCI_MINIMUM_SPEED - output, 255, -255);
-//         if(newLeftSpeed < 0)
-// 			mhi_PrintString("newLeftSpeed: -");
-// 		else
-// 			mhi_PrintString("newLeftSpeed: ");
-//          mhi_PrintInt(abs(newLeftSpeed));
-//          mhi_PrintString("\r\n");
-// 		 
-// 		 if(newRightSpeed < 0)
-// 			mhi_PrintString("newRightSpeed: -");
-// 		 else
-// 			mhi_PrintString("newRightSpeed: ");
-//          mhi_PrintInt(abs(newRightSpeed));
-//          mhi_PrintString("\r\n");
-//         
-        /* set new motor speeds */
-        if (newLeftSpeed < 0)
+        if (abs(distanceError) <= MCI_ALIGN_DISTANCE_TOLERANCE)
         {
-            mhi_SetWheelMotor1Speed((uint16_t)abs(newLeftSpeed));
-            mhi_StartWheelMotor1Backward();
+            forward = 0;
+            sf_ResetPid(&distancePid);
         }
         else
         {
-            mhi_SetWheelMotor1Speed((uint16_t)newLeftSpeed);
-            mhi_StartWheelMotor1Forward();
+            /* positive forward closes on the wall */
+            forward = sf_UpdatePid(&distancePid, distanceError);
         }
         
-        if (newRightSpeed < 0)
+        /* both axes must stay settled for a few ticks to finish */
+        if ((rotate == 0) && (forward == 0))
         {
-            mhi_SetWheelMotor2Speed((uint16_t)abs(newRightSpeed));
-            mhi_StartWheelMotor2Backward();
+            settledTicks++;
+            if (settledTicks >= MCI_ALIGN_SETTLE_TICKS)
+            {
+                status = MCI_MOVE_DONE;
+                break;
+            }
         }
         else
         {
-            mhi_SetWheelMotor2Speed((uint16_t)newRightSpeed);
-            mhi_StartWheelMotor2Forward();
+            settledTicks = 0u;
         }
+        
+        mci_DriveWheels(forward - rotate, forward + rotate);
     }
     
     /* clear encoder edge counts and set motor speeds to 0 */
     mhi_StopWheelMotor1();
     mhi_StopWheelMotor2();
-    mhi_ClearEncoder1EdgeCount();
-    mhi_ClearEncoder2EdgeCount();    
-}
-
-/**
-* Rotate mouse 90 degrees right
-*
-* \param None
-* \retval None
-*/
-void mci_TurnRight90Degrees(void)
-{
-    uint32_t rightDone = 0u;
-    uint32_t leftDone = 0u;
-    
-    /* reset encoder counts */
-    mhi_ClearEncoder1EdgeCount();
-    mhi_ClearEncoder2EdgeCount();
+    mci_ClearEncoderCounts();
     
-    /* set motor directions and speeds */
-    mhi_SetWheelMotor1Speed(MCI_TURN_SPEED);
-    mhi_SetWheelMotor2Speed(MCI_TURN_SPEED);
-    mhi_StartWheelMotor1Forward();
-    mhi_StartWheelMotor2Backward();
-    
-    /* keep moving motors until encoder edge counts are reached */
-    while ((!rightDone) || (!leftDone))
-    {      
-        if ((!rightDone) && (mhi_GetEncoder1EdgeCount() == 
-            MCI_WHEEL_MOTOR_EDGES_PER_90_DEGREE_TURN_RIGHT))
-        {
-            mhi_StopWheelMotor1();
-            rightDone = 1u;
-        }
-        if ((!leftDone) && (mhi_GetEncoder2EdgeCount() == 
-            (-MCI_WHEEL_MOTOR_EDGES_PER_90_DEGREE_TURN_RIGHT)))
+    /* square to a wall at the center of the square- remove drift */
+    if (status == MCI_MOVE_DONE)
+    {
+        if ((failed & MCI_IR_FAILED_FRONT_PAIR) == 0u)
         {
-            mhi_StopWheelMotor2();
-            leftDone = 1u;
+            mci_SnapHeadingToMaze();
         }
+        mci_SnapPositionAlongHeading(0, MCI_MAZE_SQUARE_LENGTH_MM, 0);
     }
     
-    /* update wall presences */
-    mci_UpdateWallPresenceRightTurn();
-    
-    
-    /* clear encoder edge counts and set motor speeds to 0 */
-    mhi_StopWheelMotor1();
-    mhi_StopWheelMotor2();
-    mhi_ClearEncoder1EdgeCount();
-    mhi_ClearEncoder2EdgeCount();
+    return status;
 }
 
 /**
-* Rotate mouse 90 degrees left
+* Back into the wall behind the mouse, then pull forward to square center
+*
+* Meant for dead ends right after the turn out of them. The mouse reverses
+* slowly w/ the encoders holding heading until neither wheel counts an edge
+* for a while- its back is then flat on the wall at a known distance from
+* the square center, so the pose heading and position along the heading are
+* snapped before the short pull forward.
+*
+* Contact only counts after some reversing. W/o contact the mouse drives
+* forward as far as it reversed, so it ends up in the square it started in.
 *
 * \param None
-* \retval None
+* \retval MCI_MOVE_DONE Touched the wall, pose snapped, back at center
+* \retval MCI_MOVE_TIMEOUT No wall found, back where it started, pose kept
+* \retval MCI_MOVE_STALLED Wheels blocked on the way forward
 */
-void mci_TurnLeft90Degrees(void)
+mci_move_status_t mci_RecalibrateOnBackWall(void)
 {
-    uint32_t rightDone = 0u;
-    uint32_t leftDone = 0u;
+    mci_move_status_t status = MCI_MOVE_TIMEOUT;
+    uint32_t elapsedMs = 0u;
+    uint32_t ticks = 0u;
+    uint32_t stillTicks = 0u;
+    int32_t leftEdges = 0;
+    int32_t rightEdges = 0;
+    int32_t lastLeftEdges = 0;
+    int32_t lastRightEdges = 0;
+    int32_t reversedEdges = 0;
+    int32_t minimumEdges = 0;
+    int32_t output = 0;
+    sf_pid_t headingPid;
+    const mci_settings_t *p_settings = mci_GetSettings();
+    mci_move_params_t moveParams =
+    {
+        .distanceEdges = mci_ConvertMmToEdges(
+            SF_Q16_FROM_INT(MCI_BACKUP_CONTACT_OFFSET_MM)),
+        .manoeuvre = MCI_MANOEUVRE_STRAIGHT,
+        .profile =
+        {
+            .cruiseSpeed = MCI_BACKUP_PULL_FORWARD_SPEED,
+            .endSpeed = MCI_APPROACH_CRAWL_SPEED,
+            .decelEdges = 0
+        },
+        .centering = MCI_CENTERING_NONE,
+        .stopCondition = MCI_STOP_AT_DISTANCE,
+        .wallUpdates = MCI_WALL_UPDATE_NOT_AVAILABLE,
+        .edgeCorrection = MCI_EDGE_CORRECTION_OFF
+    };
     
-    /* reset encoder counts */
-    mhi_ClearEncoder1EdgeCount();
-    mhi_ClearEncoder2EdgeCount();
+    sf_InitPid(&headingPid, p_settings->headingGains.kp, 
+        p_settings->headingGains.ki, p_settings->headingGains.kd,
+        -MCI_BACKUP_SPEED, MCI_BACKUP_SPEED);
     
-    /* set motor directions and speeds */
-    mhi_SetWheelMotor1Speed(MCI_TURN_SPEED);
-    mhi_SetWheelMotor2Speed(MCI_TURN_SPEED);
-    mhi_StartWheelMotor1Backward();
-    mhi_StartWheelMotor2Forward();
+    /* edges summed over both wheels */
+    minimumEdges = 2 * mci_ConvertMmToEdges(
+        SF_Q16_FROM_INT(MCI_BACKUP_MINIMUM_TRAVEL_MM));
     
-    /* keep moving motors until encoder edge counts are reached */
-    while ((!rightDone) || (!leftDone))
-    {    
-        if ((!rightDone) && (mhi_GetEncoder1EdgeCount() == (-MCI_WHEEL_MOTOR_EDGES_PER_90_DEGREE_TURN_LEFT)))
+    /* reset encoder counts */
+    mci_ClearEncoderCounts();
+    
+    while (elapsedMs < MCI_BACKUP_TIMEOUT_MS)
+    {
+        mci_WaitForControlTick();
+        mci_UpdateOdometry();
+        elapsedMs += MCI_CONTROL_TICK_MS;
+        ticks++;
+        
+        leftEdges = (int32_t)mhi_GetEncoder1EdgeCount();
+        rightEdges = (int32_t)mhi_GetEncoder2EdgeCount();
+        reversedEdges = -(leftEdges + rightEdges);
+        
+        /* pushing on the wall- the stall is the contact, not a fault */
+        if ((leftEdges == lastLeftEdges) && (rightEdges == lastRightEdges) && 
+            (reversedEdges >= minimumEdges))
         {
-            mhi_StopWheelMotor1();
-            rightDone = 1u;
+            stillTicks++;
         }
-        if ((!leftDone) && (mhi_GetEncoder2EdgeCount() == MCI_WHEEL_MOTOR_EDGES_PER_90_DEGREE_TURN_LEFT))
+        else
         {
-            mhi_StopWheelMotor2();
-            leftDone = 1u;
+            stillTicks = 0u;
+        }
+        lastLeftEdges = leftEdges;
+        lastRightEdges = rightEdges;
+        
+        if ((stillTicks >= MCI_BACKUP_CONTACT_TICKS) || 
+            ((ticks > MCI_BACKUP_INRUSH_TICKS) && 
+            (reversedEdges >= minimumEdges) && 
+            (mhi_CheckWheelMotorCurrentLimit() == 
+            MHI_WHEEL_MOTOR_CURRENT_LIMITED)))
+        {
+            status = MCI_MOVE_DONE;
+            break;
+        }
+        
+        /* open behind after all- give up */
+        if (reversedEdges > (2 * MCI_BACKUP_MAXIMUM_EDGES))
+        {
+            break;
         }
+        
+        /* left wheel further back means the tail swung left */
+        output = sf_UpdatePid(&headingPid, leftEdges - rightEdges);
+        mci_DriveWheels(-MCI_BACKUP_SPEED - output, 
+            -MCI_BACKUP_SPEED + output);
     }
     
-    /* update wall presences */
-    mci_UpdateWallPresenceLeftTurn();
-    
     /* clear encoder edge counts and set motor speeds to 0 */
     mhi_StopWheelMotor1();
     mhi_StopWheelMotor2();
-    mhi_ClearEncoder1EdgeCount();
-    mhi_ClearEncoder2EdgeCount();
-}
-
-/**
-* Adjust mouse to front wall
-*
-* \param None
-* \retval None
-*/
-void mci_AdjustToFrontWall(void)
-{
-    uint32_t ir1Reading = 0u;
-    uint32_t ir4Reading = 0u;
+    mci_ClearEncoderCounts();
     
-    /* read both sensors */
-    ir1Reading = mhi_ReadIr1();
-    ir4Reading = mhi_ReadIr4();
-// 	mhi_PrintString("stopped motor 2: ");
-// 	mhi_PrintInt(mhi_GetEncoder2EdgeCount());
-// 	mhi_PrintString("\r\n");
-    
-//     while (abs(ir1Reading - ir4Reading) > 1)
-//     {
-		
-        if (ir1Reading > ir4Reading)
+    if (status != MCI_MOVE_DONE)
+    {
+#if defined(DEBUG_MCI_MOVEMENT_ENABLE) && (DEBUG_MCI_MOVEMENT_ENABLE == 1)
+        mhi_PrintString("Back wall not found\r\n");
+#endif /* DEBUG_MCI_MOVEMENT_ENABLE */
+        
+        /* undo the reversing so the maze position still holds */
+        if (reversedEdges > 0)
         {
-            mhi_StartWheelMotor1Backward();
-            mhi_StartWheelMotor2Forward();
-            mhi_SetWheelMotor1Speed(100);
-            mhi_SetWheelMotor2Speed(100);
-            
-            while (abs(ir1Reading - ir4Reading) > 10)
+            moveParams.distanceEdges = reversedEdges / 2;
+            if (mci_MoveForward(&moveParams) == MCI_MOVE_STALLED)
             {
-                /* read both sensors */
-                ir1Reading = mhi_ReadIr1();
-                ir4Reading = mhi_ReadIr4();
-// 				mhi_PrintString("Left IR: ");
-// 				mhi_PrintInt(ir1Reading);
-// 				mhi_PrintString("\r\n");
-// 				mhi_PrintString("Right IR: ");
-// 				mhi_PrintInt(ir4Reading);
-// 				mhi_PrintString("\r\n");
+                status = MCI_MOVE_STALLED;
             }
         }
-        else if (ir1Reading < ir4Reading)
-        {
-            mhi_StartWheelMotor1Forward();
-            mhi_StartWheelMotor2Backward();
-            mhi_SetWheelMotor1Speed(100);
-            mhi_SetWheelMotor2Speed(100);
-            
-            while (abs(ir1Reading - ir4Reading) > 10)
-            {
-                /* read both sensors */
-                ir1Reading = mhi_ReadIr1();
-                ir4Reading = mhi_ReadIr4();
-// 				mhi_PrintString("Left IR: ");
-// 				mhi_PrintInt(ir1Reading);
-// 				mhi_PrintString("\r\n");
-// 				mhi_PrintString("Right IR: ");
-// 				mhi_PrintInt(ir4Reading);
-// 				mhi_PrintString("\r\n");
-            }
-        }	
-//    }
+        return status;
+    }
     
-    /* clear encoder edge counts and set motor speeds to 0 */
-    mhi_ClearEncoder1EdgeCount();
-    mhi_ClearEncoder2EdgeCount();
-    mhi_SetWheelMotor1Speed(0);
-    mhi_SetWheelMotor2Speed(0);
+    /* flat on the wall behind- heading and distance are both known */
+    mci_SnapHeadingToMaze();
+    mci_SnapPositionAlongHeading(-MCI_BACKUP_CONTACT_OFFSET_MM, 
+        MCI_MAZE_SQUARE_LENGTH_MM, 0);
+    
+    if (mci_MoveForward(&moveParams) == MCI_MOVE_STALLED)
+    {
+        status = MCI_MOVE_STALLED;
+    }
+    
+    return status;
 }
 
 /**
@@ -632,43 +672,9 @@ mci_wall_presence_t mci_CheckRightWallMoveForwardPid(void)
 * @param none
 * @return none
 */
-void mci_TurnRight45Degrees(void){
-	uint32_t rightDone = 0u;
-	uint32_t leftDone = 0u;
-	
-	/* reset encoder counts */
-	mhi_ClearEncoder1EdgeCount();
-	mhi_ClearEncoder2EdgeCount();
-	
-	/* set motor directions and speeds */
-	mhi_SetWheelMotor1Speed(MCI_TURN_SPEED);
-	mhi_SetWheelMotor2Speed(MCI_TURN_SPEED);
-	mhi_StartWheelMotor1Forward();
-	mhi_StartWheelMotor2Backward();
-	
-	/* keep moving motors until encoder edge counts are reached */
-	while ((!rightDone) || (!leftDone))
-	{
-		if ((!rightDone) && (mhi_GetEncoder1EdgeCount() == MCI_WHEEL_MOTOR_EDGES_PER_45_DEGREE_TURN_RIGHT))
-		{
-			mhi_StopWheelMotor1();
-			rightDone = 1u;
-		}
-		if ((!leftDone) && (mhi_GetEncoder2EdgeCount() == (-MCI_WHEEL_MOTOR_EDGES_PER_45_DEGREE_TURN_RIGHT)))
-		{
-			mhi_StopWheelMotor2();
-			leftDone = 1u;
-		}
-	}
-	
-	/* update wall presences */
-// 	mci_UpdateWallPresenceLeftTurn(); Leftover from 90 deg turn might not need to use since this will only be used during fast traversal
-	
-	/* clear encoder edge counts and set motor speeds to 0 */
-	mhi_StopWheelMotor1();
-	mhi_StopWheelMotor2();
-	mhi_ClearEncoder1EdgeCount();
-	mhi_ClearEncoder2EdgeCount();
+void mci_TurnRight45Degrees(void)
+{
+    (void)mci_TurnByAngle(45, mci_GetTurnProfile());
 }
 
 /**
@@ -678,565 +684,651 @@ void mci_TurnRight45Degrees(void){
 * @return none
 */
 
-void mci_TurnLeft45Degrees(void){
-	uint32_t rightDone = 0u;
-	uint32_t leftDone = 0u;
-	    
-	/* reset encoder counts */
-	mhi_ClearEncoder1EdgeCount();
-	mhi_ClearEncoder2EdgeCount();
-	    
-	/* set motor directions and speeds */
-	mhi_SetWheelMotor1Speed(MCI_TURN_SPEED);
-	mhi_SetWheelMotor2Speed(MCI_TURN_SPEED);
-	mhi_StartWheelMotor1Backward();
-	mhi_StartWheelMotor2Forward();
-	    
-	/* keep moving motors until encoder edge counts are reached */
-	while ((!rightDone) || (!leftDone))
-	{
-		if ((!rightDone) && (mhi_GetEncoder1EdgeCount() == (-MCI_WHEEL_MOTOR_EDGES_PER_45_DEGREE_TURN_LEFT)))
-		{
-			mhi_StopWheelMotor1();
-			rightDone = 1u;
-		}
-		if ((!leftDone) && (mhi_GetEncoder2EdgeCount() == MCI_WHEEL_MOTOR_EDGES_PER_45_DEGREE_TURN_LEFT))
-		{
-			mhi_StopWheelMotor2();
-			leftDone = 1u;
-		}
-	}
-	    
-	/* update wall presences */
-// 	    mci_UpdateWallPresenceLeftTurn(); Left over from regular 90 deg turn
-	    
-	/* clear encoder edge counts and set motor speeds to 0 */
-	mhi_StopWheelMotor1();
-	mhi_StopWheelMotor2();
-	mhi_ClearEncoder1EdgeCount();
-	mhi_ClearEncoder2EdgeCount();
-	
-}
-
-//TODO work in progress for diagonal movement
-void mci_MoveCentertoCenterPid(void){
-	/* initialize encoder PID constants (integral term not needed) */
-	float kp = 2;      /* proportional term */
-	float kd = 0.2;    /* derivative term */
-	    
-	/* initialize sensor PD constants */
-	float kpSensor = 0.1; //might have been 0.05
-	float kdSensor = 0.01;
-	    
-	/* initialize left sensor PD constants */
-	float kpSensorL = 0.1; // was 5
-	float kdSensorL = 5;
-	    
-	/* initialize right sensor PD constants */
-	float kpSensorR = 0.1; // was 5
-	float kdSensorR = 5;
-	    
-	/* other encoder PID variables */
-	int32_t initialPosition = mhi_GetEncoder1EdgeCount() + mhi_GetEncoder2EdgeCount();
-	int32_t targetPosition = initialPosition + (112*2);
-	int32_t targetAngle = 0;
-	int32_t prevError = 0;
-	float error = 0;
-	float dError = 0;
-	    
-	/* other sensor PD variables */
-	int32_t output = 0;
-	int32_t outputSensors = 0;
-	int32_t prevErrorSensors = 0;
-	int32_t errorSensors = 0;
-	float dErrorSensors = 0;
-	    
-	/* other left sensor PD variables */
-	float errorSensorLeft = 0;
-	    
-	/* other right sensor PD variables */
-	float errorSensorRight = 0;
-	    
-	/* new motor speeds provided all PDs */
-	int32_t newLeftSpeed = 0;
-	int32_t newRightSpeed = 0;
-	    
-	/* IR sensor variables */
-	uint32_t ir2Reading = 0u;
-	uint32_t ir3Reading = 0u;
-	    
-	/* local wall presence variables */
-	mci_wall_presence_t leftWall = MCI_CANNOT_READ_WALL;
-	mci_wall_presence_t rightWall = MCI_CANNOT_READ_WALL;
-	    
-	/* configure both motors to move forward at base speed */
-	mhi_SetWheelMotor1Speed(MCI_FORWARD_FAST_SPEED);
-	mhi_SetWheelMotor2Speed(MCI_FORWARD_FAST_SPEED);
-	mhi_StartWheelMotor1Forward();
-	mhi_StartWheelMotor2Forward();
-	    
-	/*regular moveforward allow wall updates on start dont think this is needed for this function*/
-// 	mci_SetLeftWallUpdateAvailable();
-// 	mci_SetRightWallUpdateAvailable();
-	    
-	/* set up target and initial position */
-	mhi_ClearEncoder1EdgeCount();
-	mhi_ClearEncoder2EdgeCount();
-	initialPosition = mhi_GetEncoder1EdgeCount() + mhi_GetEncoder2EdgeCount();
-	targetPosition = initialPosition + (112*2);
-	    
-	    
-	/* main control loop */
-	while ((mhi_GetEncoder1EdgeCount() + mhi_GetEncoder2EdgeCount()) < targetPosition)
-	{		    
-		/* check for walls for PID move forward */
-		leftWall = mci_CheckLeftWallMoveForwardPid();
-		rightWall = mci_CheckRightWallMoveForwardPid();
-		    
-		//output error sensors
-		if ((leftWall == MCI_WALL_FOUND) && (rightWall != MCI_WALL_FOUND))
-		{
-			mhi_ClearD1Led();
-			mhi_ClearD3Led();
-			mhi_SetD2Led();
-			    
-			//Read left one
-			ir2Reading = mhi_ReadIr2();
-			    
-			//error with just left sensor
-			errorSensorLeft = MCI_LEFT_SENSOR_READING_THRESHOLD_RAW - ir2Reading;
-			errorSensors = -errorSensorLeft * 2;
-			dErrorSensors = errorSensors - prevErrorSensors;
-			outputSensors = (kpSensorL * errorSensors) + (kdSensorL * dErrorSensors);
-			prevErrorSensors = errorSensors;
-		}
-		    
-		else if ((rightWall == MCI_WALL_FOUND) && (leftWall != MCI_WALL_FOUND))
-		{
-			mhi_ClearD1Led();
-			mhi_ClearD2Led();
-			mhi_SetD3Led();
-			    
-			//Read Right one
-			ir3Reading = mhi_ReadIr3();
-			    
-			errorSensorRight = MCI_RIGHT_SENSOR_READING_THRESHOLD_RAW - ir3Reading;
-			errorSensors = errorSensorRight * 2;
-			dErrorSensors = errorSensors - prevErrorSensors;
-			outputSensors = (kpSensorR * errorSensors) + (kdSensorR * dErrorSensors);
-			prevErrorSensors = errorSensors;
-		}
-		    
-		else
-		{
-			outputSensors = 0;
-			prevErrorSensors = 0;
-		}
-		    
-		/* calculate error (for proportional term) */
-		error = targetAngle - ((int32_t)mhi_GetEncoder1EdgeCount() - (int32_t)mhi_GetEncoder2EdgeCount());
-		    
-		/* calculate difference in error (for the derivative term) */
-		error += outputSensors;
-		dError = error - prevError;
-		prevError = error;
-		    
-		/* calculate PID output */
-		output = (kp * error) + (kd * dError);
-		    
-		/* calculate new speeds */
-		newLeftSpeed = sf_constrain(MCI_MINIMUM_SPEED + output, 255, -255);
-		newRightSpeed = sf_constrain(MCI_MINIMUM_SPEED - output, 255, -255);
-		    
-		    
-		/* set new motor speeds */
-		if (newLeftSpeed < 0)
-		{
-			mhi_SetWheelMotor1Speed((uint16_t)abs(newLeftSpeed));
-			mhi_StartWheelMotor1Backward();
-		}
-		else
-		{
-			mhi_SetWheelMotor1Speed((uint16_t)newLeftSpeed);
-			mhi_StartWheelMotor1Forward();
-		}
-		    
-		if (newRightSpeed < 0)
-		{
-			mhi_SetWheelMotor2Speed((uint16_t)abs(newRightSpeed));
-			mhi_StartWheelMotor2Backward();
-		}
-		else
-		{
-			mhi_SetWheelMotor2Speed((uint16_t)newRightSpeed);
-			mhi_StartWheelMotor2Forward();
-		}
-	}
-	    
-	/* clear encoder edge counts and set motor speeds to 0 */
-	mhi_StopWheelMotor1();
-	mhi_StopWheelMotor2();
-	mhi_ClearEncoder1EdgeCount();
-	mhi_ClearEncoder2EdgeCount();
+void mci_TurnLeft45Degrees(void)
+{
+    (void)mci_TurnByAngle(-45, mci_GetTurnProfile());
 }
 
-//TODO work in progress test in a long straight + deaccelerate on last square
-void mci_MoveForwardNSquares(int n){
-	/* initialize encoder PID constants (integral term not needed) */
-	float kp = 2;      /* proportional term */
-	float kd = 0.2;    /* derivative term */
-	
-	/* initialize sensor PD constants */
-	float kpSensor = 0.05;
-	float kdSensor = 0.01;
-	
-	/* initialize left sensor PD constants */
-	float kpSensorL = 0.5; // was 5
-	float kdSensorL = 5;
-	
-	/* initialize right sensor PD constants */
-	float kpSensorR = 0.5; // was 5
-	float kdSensorR = 5;
-	
-	/* other encoder PID variables */
-	int32_t initialPosition = mhi_GetEncoder1EdgeCount() + mhi_GetEncoder2EdgeCount();
-	int32_t targetPosition = initialPosition + ((MCI_WHEEL_MOTOR_EDGES_PER_MAZE_SQR_CONTINOUS*n)*2);
-	int32_t targetAngle = 0;
-	int32_t prevError = 0;
-	float error = 0;
-	float dError = 0;
-	
-	/* other sensor PD variables */
-	int32_t output = 0;
-	int32_t outputSensors = 0;
-	int32_t prevErrorSensors = 0;
-	int32_t errorSensors = 0;
-	float dErrorSensors = 0;
-	
-	/* other left sensor PD variables */
-	float errorSensorLeft = 0;
-	
-	/* other right sensor PD variables */
-	float errorSensorRight = 0;
-	
-	/* new motor speeds provided all PDs */
-	int32_t newLeftSpeed = 0;
-	int32_t newRightSpeed = 0;
-	
-	/* IR sensor variables */
-	uint32_t ir2Reading = 0u;
-	uint32_t ir3Reading = 0u;
-	
-	/* local wall presence variables */
-	mci_wall_presence_t leftWall = MCI_CANNOT_READ_WALL;
-	mci_wall_presence_t rightWall = MCI_CANNOT_READ_WALL;
-	
-	/* configure both motors to move forward at base speed */
-	mhi_SetWheelMotor1Speed(MCI_FORWARD_FAST_SPEED);
-	mhi_SetWheelMotor2Speed(MCI_FORWARD_FAST_SPEED);
-	mhi_StartWheelMotor1Forward();
-	mhi_StartWheelMotor2Forward();
-	
-	/* allow wall updates on start */
-	// 	mci_SetLeftWallUpdateAvailable();
-	// 	mci_SetRightWallUpdateAvailable();
-	
-	/* set up target and initial position */
-	mhi_ClearEncoder1EdgeCount();
-	mhi_ClearEncoder2EdgeCount();
-	initialPosition = mhi_GetEncoder1EdgeCount() + mhi_GetEncoder2EdgeCount();
-	targetPosition = initialPosition + ((MCI_WHEEL_MOTOR_EDGES_PER_MAZE_SQR_CONTINOUS*n)*2);
-	
-	
-	/* main control loop */
-	while ((mhi_GetEncoder1EdgeCount() + mhi_GetEncoder2EdgeCount()) < targetPosition)
-	{	
-		/* check for walls while moving diagonally for PID */
-		leftWall = mci_CheckLeftWallMoveForwardPid();
-		rightWall = mci_CheckRightWallMoveForwardPid();
-		
-		//output error sensors
-		if ((leftWall == MCI_WALL_FOUND) && (rightWall == MCI_WALL_FOUND))
-		{
-			mhi_ClearD2Led();
-			mhi_ClearD3Led();
-			mhi_SetD1Led();
-			
-			/* read left wall sensor */
-			ir2Reading = mhi_ReadIr2();
-			
-			/* read right wall sensor */
-			ir3Reading = mhi_ReadIr3();
-			
-			// Error with the sensors
-			errorSensorLeft =  MCI_LEFT_SENSOR_READING_THRESHOLD_RAW - ir2Reading;
-			errorSensorRight = MCI_RIGHT_SENSOR_READING_THRESHOLD_RAW - ir3Reading;
-			errorSensors =  errorSensorRight - errorSensorLeft;
-			dErrorSensors = errorSensors - prevErrorSensors;
-			
-			// Current way of trying to add a pid controller to the mouse using the sensors going to aggregate with the other output
-			outputSensors = (kpSensor * errorSensors) + (kdSensor * dErrorSensors);
-			
-			prevErrorSensors = errorSensors;
-		}
-		
-		else if ((leftWall == MCI_WALL_FOUND) && (rightWall != MCI_WALL_FOUND))
-		{
-			mhi_ClearD1Led();
-			mhi_ClearD3Led();
-			mhi_SetD2Led();
-			
-			//Read left one
-			ir2Reading = mhi_ReadIr2();
-			
-			//error with just left sensor
-			errorSensorLeft = MCI_LEFT_SENSOR_READING_THRESHOLD_RAW - ir2Reading;
-			//errorSensors = -errorSensorLeft * 2;
-			errorSensors = -errorSensorLeft;
-			dErrorSensors = errorSensors - prevErrorSensors;
-			outputSensors = (kpSensorL * errorSensors) + (kdSensorL * dErrorSensors);
-			// 			 if(targetAngle - (g_sbu_mm_Motor1EncoderEdgeCount - g_sbu_mm_Motor2EncoderEdgeCount) < -45){
-			// 				outputSensors*=-1;
-			// 			 }
-			prevErrorSensors = errorSensors;
-		}
-		
-		else if ((rightWall == MCI_WALL_FOUND) && (leftWall != MCI_WALL_FOUND))
-		{
-			mhi_ClearD1Led();
-			mhi_ClearD2Led();
-			mhi_SetD3Led();
-			
-			//Read Right one
-			ir3Reading = mhi_ReadIr3();
-			
-			errorSensorRight = MCI_RIGHT_SENSOR_READING_THRESHOLD_RAW - ir3Reading;
-			//errorSensors = errorSensorRight * 2;
-			errorSensors = errorSensorRight;
-			dErrorSensors = errorSensors - prevErrorSensors;
-			outputSensors = (kpSensorR * errorSensors) + (kdSensorR * dErrorSensors);
-			// 			  if(targetAngle - (g_sbu_mm_Motor1EncoderEdgeCount - g_sbu_mm_Motor2EncoderEdgeCount) < 45){
-			// 				  outputSensors*=-1;
-			// 			  }
-			prevErrorSensors = errorSensors;
-		}
-		
-		else
-		{
-			outputSensors = 0;
-			prevErrorSensors = 0;
-		}
-		
-		/* calculate error (for proportional term) */
-		error = targetAngle - ((int32_t)mhi_GetEncoder1EdgeCount() - (int32_t)mhi_GetEncoder2EdgeCount());
-		uint32_t distanceError = targetPosition - (mhi_GetEncoder1EdgeCount() + mhi_GetEncoder2EdgeCount());
-		/* Check to see if a less than one square is left to traverse to calculate error deceleration*/
-		if(distanceError < (MCI_WHEEL_MOTOR_EDGES_PER_MAZE_SQUARE+10)){
-			 distanceError/=((float)MCI_WHEEL_MOTOR_EDGES_PER_MAZE_SQUARE+10);
-		}
-		else{
-			distanceError = 1;
-		}
-		/* calculate difference in error (for the derivative term) */
-		error += outputSensors;
-		dError = error - prevError;
-		prevError = error;
-		
-		/* calculate PID output */
-		output = (kp * error) + (kd * dError);
-// 		output*=distanceError;
-		/* calculate new speeds */
-		newLeftSpeed = sf_constrain(MCI_MINIMUM_SPEED + output, 255, -255);
-		newRightSpeed = sf_constrain(MCI_MINIMUM_SPEED - output, 255, -255);
-		
-		
-		/* set new motor speeds */
-		if (newLeftSpeed < 0)
-		{
-			mhi_SetWheelMotor1Speed((uint16_t)abs(newLeftSpeed));
-			mhi_StartWheelMotor1Backward();
-		}
-		else
-		{
-			mhi_SetWheelMotor1Speed((uint16_t)newLeftSpeed);
-			mhi_StartWheelMotor1Forward();
-		}
-		
-		if (newRightSpeed < 0)
-		{
-			mhi_SetWheelMotor2Speed((uint16_t)abs(newRightSpeed));
-			mhi_StartWheelMotor2Backward();
-		}
-		else
-		{
-			mhi_SetWheelMotor2Speed((uint16_t)newRightSpeed);
-			mhi_StartWheelMotor2Forward();
-		}
-	}
-	
-	/* clear encoder edge counts and set motor speeds to 0 */
-	mhi_StopWheelMotor1();
-	mhi_StopWheelMotor2();
-	mhi_ClearEncoder1EdgeCount();
-	mhi_ClearEncoder2EdgeCount();
+/**
+* Move mouse from the center of one maze square to the center of a
+* diagonally adjacent maze square using PID
+*
+* TODO: work in progress for diagonal movement
+*
+* \param None
+* \retval None
+*/
+void mci_MoveCentertoCenterPid(void)
+{
+    mci_move_params_t moveParams =
+    {
+        .distanceEdges = MCI_WHEEL_MOTOR_EDGES_PER_DIAGONAL_MOVE,
+        .manoeuvre = MCI_MANOEUVRE_DIAGONAL,
+        .profile =
+        {
+            .cruiseSpeed = MCI_FORWARD_FAST_SPEED,
+            .endSpeed = MCI_MINIMUM_SPEED,
+            .decelEdges = 0
+        },
+        .centering = MCI_CENTERING_SINGLE_WALL,
+        .stopCondition = MCI_STOP_AT_DISTANCE,
+        .wallUpdates = MCI_WALL_UPDATE_NOT_AVAILABLE,
+        .edgeCorrection = MCI_EDGE_CORRECTION_OFF
+    };
+    
+    (void)mci_MoveForward(&moveParams);
 }
 
 /**
-* Rotate mouse 90 degrees right with some deacceleeration
+* Move mouse n maze squares forward in one continuous motion using PID
 *
-* \param None
+* TODO: work in progress- test in a long straight
+*
+* \param[in] n Number of maze squares to move forward
 * \retval None
 */
-void mci_TurnRight90DegreesPID(void){
-    uint32_t rightDone = 0u;
-    uint32_t leftDone = 0u;
-    float kp = 1;      /* proportional term */
-    float kd = 0.5;    /* derivative term */
-	int32_t targetAngle = 0;
-    int32_t prevErrorLeft = 0;
-	int32_t prevErrorRight = 0;
-    float errorLeft = 0;
-    float dErrorLeft = 0;
-	float errorRight = 0;
-    float dErrorRight = 0;
-	int32_t outputLeft = 0;
-	int32_t outputRight = 0;
+void mci_MoveForwardNSquares(int n)
+{
+    mci_move_params_t moveParams =
+    {
+        .distanceEdges = MCI_WHEEL_MOTOR_EDGES_PER_MAZE_SQR_CONTINOUS * n,
+        .manoeuvre = MCI_MANOEUVRE_STRAIGHT,
+        .profile =
+        {
+            .cruiseSpeed = MCI_FORWARD_FAST_SPEED,
+            .endSpeed = MCI_MINIMUM_SPEED,
+            .decelEdges = MCI_WHEEL_MOTOR_EDGES_PER_MAZE_SQUARE
+        },
+        .centering = MCI_CENTERING_ALL_WALLS,
+        .stopCondition = MCI_STOP_AT_DISTANCE,
+        .wallUpdates = MCI_WALL_UPDATE_NOT_AVAILABLE,
+        .edgeCorrection = MCI_EDGE_CORRECTION_ON
+    };
+    
+    (void)mci_MoveForward(&moveParams);
+}
 
-    /* reset encoder counts */
-    mhi_ClearEncoder1EdgeCount();
-    mhi_ClearEncoder2EdgeCount();
+/**
+* Move mouse forward w/ the shared straight line PID controller
+*
+* All forward moves run through this engine so that they share one set of
+* gains and the same control loop period. Speed ramps up from rest under an
+* acceleration limit that drops whenever wheel slip is seen. Blocks until
+* the move ends- see mci_StartMove() to do other work while moving.
+*
+* \param[in] p_params Distance, speed profile, centering and stop condition
+* \retval How the move ended, see mci_PollMove()
+*/
+mci_move_status_t mci_MoveForward(const mci_move_params_t *p_params)
+{
+    mci_move_status_t status = MCI_MOVE_RUNNING;
     
-    /* set motor directions and speeds */
-    mhi_SetWheelMotor1Speed(MCI_TURN_SPEED);
-    mhi_SetWheelMotor2Speed(MCI_TURN_SPEED); //140 speed default
-    mhi_StartWheelMotor1Forward();
-    mhi_StartWheelMotor2Backward();
+    mci_StartMove(p_params);
     
-    /* keep moving motors until encoder edge counts are reached */
-    while ((!rightDone) || (!leftDone))
+    while ((status = mci_PollMove()) == MCI_MOVE_RUNNING)
     {
-		errorRight = MCI_WHEEL_MOTOR_EDGES_PER_90_DEGREE_TURN_RIGHT_PID - (-1*mhi_GetEncoder1EdgeCount());
-		errorLeft = MCI_WHEEL_MOTOR_EDGES_PER_90_DEGREE_TURN_RIGHT_PID - (mhi_GetEncoder2EdgeCount());
-		dErrorRight = errorRight - prevErrorRight;
-		dErrorLeft = errorLeft - prevErrorLeft;
-		prevErrorRight = errorRight;
-		prevErrorLeft = errorLeft;
-		
-
-		outputRight = (kp * errorRight) + (kd * dErrorRight);
-		outputLeft = (kp * errorLeft) + (kd * dErrorLeft);
-		int32_t newRightSpeed = 90 + outputRight;
-		int32_t newLeftSpeed = 90 + outputLeft;
-
-		mhi_SetWheelMotor1Speed((uint16_t)abs(newLeftSpeed));
-		mhi_StartWheelMotor1Forward();
-		mhi_SetWheelMotor2Speed((uint16_t)abs(newRightSpeed));
-		mhi_StartWheelMotor2Backward();
-
-
-	    if ((!rightDone) && (mhi_GetEncoder1EdgeCount() ==
-	    MCI_WHEEL_MOTOR_EDGES_PER_90_DEGREE_TURN_RIGHT_PID))
-	    {
-		    mhi_StopWheelMotor1();
-		    rightDone = 1u;
-	    }
-	    if ((!leftDone) && (mhi_GetEncoder2EdgeCount() ==
-	    (-MCI_WHEEL_MOTOR_EDGES_PER_90_DEGREE_TURN_RIGHT_PID)))
-	    {
-		    mhi_StopWheelMotor2();
-		    leftDone = 1u;
-	    }
+        /* wait for the move to end */
     }
     
-    /* update wall presences */
-    mci_UpdateWallPresenceRightTurn();
-    
-    
-    /* clear encoder edge counts and set motor speeds to 0 */
-    mhi_StopWheelMotor1();
-    mhi_StopWheelMotor2();
-    mhi_ClearEncoder1EdgeCount();
-    mhi_ClearEncoder2EdgeCount();
+    return status;
 }
 
 /**
-* Rotate mouse 90 degrees left with some deacceleration
+* Start a straight move w/o waiting for it to end
 *
-* \param None
+* The move only advances while mci_PollMove() is called, which must happen
+* at least once per control tick. Nothing else may drive the wheels until
+* mci_PollMove() stops returning MCI_MOVE_RUNNING.
+*
+* \param[in] p_params Distance, speed profile, centering and stop condition
 * \retval None
 */
-void mci_TurnLeft90DegreesPID(void){
-    uint32_t rightDone = 0u;
-    uint32_t leftDone = 0u;
-    float kp = 1;      /* proportional term */
-    float kd = 0.5;    /* derivative term */
-	int32_t targetAngle = 0;
-    int32_t prevErrorLeft = 0;
-	int32_t prevErrorRight = 0;
-    float errorLeft = 0;
-    float dErrorLeft = 0;
-	float errorRight = 0;
-    float dErrorRight = 0;
-	int32_t outputLeft = 0;
-	int32_t outputRight = 0;
-
-    /* reset encoder counts */
-    mhi_ClearEncoder1EdgeCount();
-    mhi_ClearEncoder2EdgeCount();
+void mci_StartMove(const mci_move_params_t *p_params)
+{
+    const mci_settings_t *p_settings = mci_GetSettings();
+    uint32_t irReadings[MHI_IR_COUNT] = {0u};
     
-    /* set motor directions and speeds */
-    mhi_SetWheelMotor1Speed(MCI_TURN_SPEED);
-    mhi_SetWheelMotor2Speed(MCI_TURN_SPEED); //140 speed default
-    mhi_StartWheelMotor1Backward();
-    mhi_StartWheelMotor2Forward();
+    activeMove.params = *p_params;
+    activeMove.targetPosition = p_params->distanceEdges * 2;
+    activeMove.position = 0;
+    activeMove.baseSpeed = 0;
+    activeMove.headingCorrection = 0;
+    activeMove.approachingWall = 0u;
+    activeMove.approachInRangeTicks = 0u;
+    activeMove.approachTicks = 0u;
+    activeMove.approachSettledTicks = 0u;
+    activeMove.slipSeen = 0u;
     
-    /* keep moving motors until encoder edge counts are reached */
-    while ((!rightDone) || (!leftDone))
+    /* start over from the new ceiling when the fan turned on or off */
+    if (mci_GetDownforce() != accelerationDownforce)
     {
-		errorRight = MCI_WHEEL_MOTOR_EDGES_PER_90_DEGREE_TURN_LEFT_PID - (mhi_GetEncoder1EdgeCount());
-		errorLeft = MCI_WHEEL_MOTOR_EDGES_PER_90_DEGREE_TURN_LEFT_PID - (-1*mhi_GetEncoder2EdgeCount());
-		dErrorRight = errorRight - prevErrorRight;
-		dErrorLeft = errorLeft - prevErrorLeft;
-		prevErrorRight = errorRight;
-		prevErrorLeft = errorLeft;
-		
-
-		outputRight = (kp * errorRight) + (kd * dErrorRight);
-		outputLeft = (kp * errorLeft) + (kd * dErrorLeft);
-		int32_t newRightSpeed = 90 + outputRight;
-		int32_t newLeftSpeed = 90 + outputLeft;
-
-		mhi_SetWheelMotor1Speed((uint16_t)abs(newLeftSpeed));
-		mhi_StartWheelMotor1Backward();
-		mhi_SetWheelMotor2Speed((uint16_t)abs(newRightSpeed));
-		mhi_StartWheelMotor2Forward();
-
-
-	    if ((!rightDone) && (mhi_GetEncoder1EdgeCount() ==
-	    (-MCI_WHEEL_MOTOR_EDGES_PER_90_DEGREE_TURN_LEFT_PID)))
-	    {
-		    mhi_StopWheelMotor1();
-		    rightDone = 1u;
-	    }
-	    if ((!leftDone) && (mhi_GetEncoder2EdgeCount() ==
-	    MCI_WHEEL_MOTOR_EDGES_PER_90_DEGREE_TURN_LEFT_PID))
-	    {
-		    mhi_StopWheelMotor2();
-		    leftDone = 1u;
-	    }
+        accelerationDownforce = mci_GetDownforce();
+        accelerationLimit = mci_GetAccelerationMaximum();
     }
     
-    /* update wall presences */
-    mci_UpdateWallPresenceLeftTurn();
+    /* fewer sensors see less of the maze- slow down to match */
+    if (mci_GetFailedIrSensors() != 0u)
+    {
+        activeMove.params.profile.cruiseSpeed = 
+            (p_params->profile.cruiseSpeed * 
+            MCI_MOVE_DEGRADED_SPEED_PERCENT) / 100;
+        activeMove.params.profile.endSpeed = 
+            (p_params->profile.endSpeed * 
+            MCI_MOVE_DEGRADED_SPEED_PERCENT) / 100;
+    }
     
+    /* start fresh wall evidence, gathered once inside the window */
+    if (p_params->wallUpdates == MCI_WALL_UPDATE_AVAILABLE)
+    {
+        mci_ResetSideWallEvidence();
+        mci_SetLeftWallUpdateUnavailable();
+        mci_SetRightWallUpdateUnavailable();
+    }
     
-    /* clear encoder edge counts and set motor speeds to 0 */
-    mhi_StopWheelMotor1();
-    mhi_StopWheelMotor2();
-    mhi_ClearEncoder1EdgeCount();
-    mhi_ClearEncoder2EdgeCount();
-}
+    /* outputs are bounded by the wheel speed range */
+    sf_InitPid(&activeMove.encoderPid, p_settings->headingGains.kp, 
+        p_settings->headingGains.ki, p_settings->headingGains.kd,
+        -MCI_MAXIMUM_SPEED, MCI_MAXIMUM_SPEED);
+    sf_InitPid(&activeMove.sensorPid, p_settings->sensorGains.kp, 
+        p_settings->sensorGains.ki, p_settings->sensorGains.kd,
+        -MCI_MAXIMUM_SPEED, MCI_MAXIMUM_SPEED);
+    
+    /* set up initial position */
+    mci_ClearEncoderCounts();
+    mci_ResetWallEdgeDetection();
+    mci_ResetSlipDetection();
+    mci_ResetStallMonitor();
+    (void)mci_ReadHealthyIr(irReadings);
+    mci_ResetWallHeadingEstimate(0, irReadings[MHI_IR2_INDEX], 
+        irReadings[MHI_IR3_INDEX]);
+    
+    /* start from rest- base speed ramps up under the acceleration limit */
+    mci_DriveWheels(activeMove.baseSpeed, activeMove.baseSpeed);
+    
+    activeMove.status = MCI_MOVE_RUNNING;
+}
+
+/**
+* Advance the straight move in progress by one control tick if one is due
+*
+* Returns right away if no control tick has passed since the last call.
+*
+* \param None
+* \retval MCI_MOVE_RUNNING Move still in progress
+* \retval MCI_MOVE_DONE Move ended (or no move was started)
+* \retval MCI_MOVE_STALLED Move aborted, wheels blocked
+*/
+mci_move_status_t mci_PollMove(void)
+{
+    const mci_move_params_t *p_params = &activeMove.params;
+    const mci_settings_t *p_settings = mci_GetSettings();
+    int32_t remaining = 0;
+    int32_t profileSpeed = 0;
+    int32_t slippedEdges = 0;
+    uint32_t slip = MCI_SLIP_NONE;
+    mci_move_status_t approachStatus = MCI_MOVE_RUNNING;
+    int32_t errorSensors = 0;
+    int32_t outputSensors = 0;
+    int32_t output = 0;
+    int32_t heading = 0;
+    int32_t wallHeading = 0;
+    
+    /* IR sensor variables */
+    uint32_t ir1Reading = 0u;
+    uint32_t ir2Reading = 0u;
+    uint32_t ir3Reading = 0u;
+    uint32_t ir4Reading = 0u;
+    uint32_t irReadings[MHI_IR_COUNT] = {0u};
+    
+    /* local wall presence variables */
+    mci_wall_presence_t leftWall = MCI_CANNOT_READ_WALL;
+    mci_wall_presence_t rightWall = MCI_CANNOT_READ_WALL;
+    
+    if ((activeMove.status != MCI_MOVE_RUNNING) || (!mci_CheckControlTick()))
+    {
+        return activeMove.status;
+    }
+    
+    mci_UpdateOdometry();
+    activeMove.position = (int32_t)mhi_GetEncoder1EdgeCount() + 
+        (int32_t)mhi_GetEncoder2EdgeCount();
+    
+    /* pinned against something- stop driving into it */
+    if (mci_CheckStall(drivenLeftSpeed, drivenRightSpeed) != MCI_STALL_NONE)
+    {
+        mci_FinishMove();
+        activeMove.status = MCI_MOVE_STALLED;
+        return activeMove.status;
+    }
+    
+    /* slipped edges did not move the mouse- push the target out */
+    slip = mci_DetectWheelSlip(&slippedEdges);
+    if (slip != MCI_SLIP_NONE)
+    {
+        activeMove.targetPosition += slippedEdges;
+        
+        /* accelerate gentler from now, and back off to regain traction */
+        /* only when a wheel spun- disagreement may be a heading correction */
+        accelerationLimit = sf_constrain(accelerationLimit / 2, 
+            mci_GetAccelerationMaximum(), MCI_MOVE_ACCELERATION_MINIMUM);
+        if ((slip & (MCI_SLIP_LEFT_WHEEL | MCI_SLIP_RIGHT_WHEEL)) != 0u)
+        {
+            activeMove.baseSpeed = sf_constrain(activeMove.baseSpeed - 
+                accelerationLimit, MCI_MAXIMUM_SPEED, 0);
+        }
+        activeMove.slipSeen = 1u;
+        
+#if defined(DEBUG_MCI_MOVEMENT_ENABLE) && (DEBUG_MCI_MOVEMENT_ENABLE == 1)
+        mhi_PrintString("Wheel slip: ");
+        mhi_PrintInt(slip);
+        mhi_PrintString(" count: ");
+        mhi_PrintInt(mci_GetSlipEventCount());
+        mhi_PrintString("\r\n");
+#endif /* DEBUG_MCI_MOVEMENT_ENABLE */
+    }
+    
+    /* read all sensors once per tick in a single scan- failed sensors */
+    /* read as the sensors left would see them */
+    (void)mci_ReadHealthyIr(irReadings);
+    ir1Reading = irReadings[MHI_IR1_INDEX];
+    ir2Reading = irReadings[MHI_IR2_INDEX];
+    ir3Reading = irReadings[MHI_IR3_INDEX];
+    ir4Reading = irReadings[MHI_IR4_INDEX];
+    
+    /* a front wall in range for a few ticks takes over the stop from the */
+    /* target, one that falls out of range hands it back */
+    if (p_params->stopCondition == MCI_STOP_AT_DISTANCE_OR_FRONT_WALL)
+    {
+        mci_UpdateFrontWallApproach(ir1Reading, ir4Reading);
+    }
+    
+    if (activeMove.approachingWall)
+    {
+        /* the target still limits how far a bad reading can drive */
+        if (activeMove.position >= 
+            (activeMove.targetPosition + MCI_APPROACH_OVERRUN_EDGES))
+        {
+            mci_FinishMove();
+            activeMove.status = MCI_MOVE_TIMEOUT;
+            return activeMove.status;
+        }
+        
+        approachStatus = mci_ApproachFrontWall(ir1Reading, ir4Reading);
+        if (approachStatus != MCI_MOVE_RUNNING)
+        {
+            mci_FinishMove();
+            activeMove.status = approachStatus;
+            return activeMove.status;
+        }
+    }
+    else if (activeMove.position >= activeMove.targetPosition)
+    {
+        mci_FinishMove();
+        return activeMove.status;
+    }
+    
+    /* side walls of the last square vote only inside the evidence window */
+    if (p_params->wallUpdates == MCI_WALL_UPDATE_AVAILABLE)
+    {
+        if (mci_IsInWallEvidenceWindow())
+        {
+            mci_SetLeftWallUpdateAvailable();
+            mci_SetRightWallUpdateAvailable();
+        }
+        else
+        {
+            mci_SetLeftWallUpdateUnavailable();
+            mci_SetRightWallUpdateUnavailable();
+        }
+        mci_UpdateLeftWallPresence();
+        mci_UpdateRightWallPresence();
+    }
+    
+    leftWall = (ir2Reading >= MCI_LEFT_SENSOR_READING_THRESHOLD_RAW) ? 
+        MCI_WALL_FOUND : MCI_WALL_NOT_FOUND;
+    rightWall = (ir3Reading >= MCI_RIGHT_SENSOR_READING_THRESHOLD_RAW) ? 
+        MCI_WALL_FOUND : MCI_WALL_NOT_FOUND;
+    
+    /* post edges pin down position along the maze- correct the target */
+    if (p_params->edgeCorrection == MCI_EDGE_CORRECTION_ON)
+    {
+        mci_CorrectPositionAtWallEdge(mci_DetectLeftWallEdge(ir2Reading),
+            &activeMove.targetPosition);
+        mci_CorrectPositionAtWallEdge(mci_DetectRightWallEdge(ir3Reading),
+            &activeMove.targetPosition);
+    }
+    
+    /* adapt settings gains to the speed the mouse is moving at */
+    mci_SchedulePid(&activeMove.encoderPid, p_params->manoeuvre, 
+        activeMove.baseSpeed, &p_settings->headingGains);
+    mci_SchedulePid(&activeMove.sensorPid, p_params->manoeuvre, 
+        activeMove.baseSpeed, &p_settings->sensorGains);
+    
+    /* sensor PD- positive error steers the mouse right */
+    if (mci_GetCenteringError(p_params->centering, leftWall, rightWall,
+        ir2Reading, ir3Reading, &errorSensors))
+    {
+        outputSensors = sf_UpdatePid(&activeMove.sensorPid, errorSensors);
+    }
+    else
+    {
+        outputSensors = 0;
+        sf_ResetPid(&activeMove.sensorPid);
+    }
+    
+    /* heading in wheel difference edges- side wall angle pulls the encoder
+       heading back when it drifts */
+    heading = ((int32_t)mhi_GetEncoder1EdgeCount() - 
+        (int32_t)mhi_GetEncoder2EdgeCount()) + activeMove.headingCorrection;
+    if ((p_params->manoeuvre == MCI_MANOEUVRE_STRAIGHT) && 
+        (p_params->centering != MCI_CENTERING_NONE) &&
+        mci_EstimateWallHeading(activeMove.position, ir2Reading, ir3Reading,
+        &wallHeading))
+    {
+        activeMove.headingCorrection += (mci_ConvertAngleToEdges(wallHeading) -
+            heading) / MCI_MOVE_WALL_HEADING_BLEND_DIVISOR;
+        heading = ((int32_t)mhi_GetEncoder1EdgeCount() - 
+            (int32_t)mhi_GetEncoder2EdgeCount()) + 
+            activeMove.headingCorrection;
+    }
+    
+    /* heading PD w/ the centering output as its setpoint */
+    output = sf_UpdatePid(&activeMove.encoderPid, outputSensors - heading);
+    
+    /* square up to the wall- left front higher means pointing right */
+    if (activeMove.approachingWall && (((ir1Reading + ir4Reading) / 2u) >= 
+        MCI_FRONT_SENSOR_READING_THRESHOLD_RAW))
+    {
+        output -= sf_Q16MulInt(MCI_ALIGN_KP_ANGLE, 
+            (int32_t)ir1Reading - (int32_t)ir4Reading);
+    }
+    
+    /* front wall distance regulation has set the base speed already */
+    if (activeMove.approachingWall)
+    {
+        mci_DriveWheels(activeMove.baseSpeed + output, 
+            activeMove.baseSpeed - output);
+        return activeMove.status;
+    }
+    
+    /* ramp base speed down over the deceleration distance */
+    remaining = activeMove.targetPosition - activeMove.position;
+    if (remaining < (p_params->profile.decelEdges * 2))
+    {
+        profileSpeed = p_params->profile.endSpeed + 
+            (((p_params->profile.cruiseSpeed - 
+            p_params->profile.endSpeed) * remaining) / 
+            (p_params->profile.decelEdges * 2));
+    }
+    else
+    {
+        profileSpeed = p_params->profile.cruiseSpeed;
+    }
+    
+    /* speed up no faster than traction allows, slow down as planned */
+    if (profileSpeed > (activeMove.baseSpeed + accelerationLimit))
+    {
+        activeMove.baseSpeed += accelerationLimit;
+    }
+    else
+    {
+        activeMove.baseSpeed = profileSpeed;
+    }
+    
+    /* set new motor speeds */
+    mci_DriveWheels(activeMove.baseSpeed + output, 
+        activeMove.baseSpeed - output);
+    
+    return activeMove.status;
+}
+
+/**
+* Check whether the straight move in progress has latched its side walls
+*
+* Side walls stop updating at the end of the wall evidence window in the
+* last square, so from then on the walls of the square being entered can be
+* read while the move finishes.
+*
+* \param None
+* \retval 1 Side walls latched (or no move in progress)
+* \retval 0 Side walls still updating
+*/
+uint32_t mci_CheckMoveWallsLatched(void)
+{
+    return ((activeMove.status != MCI_MOVE_RUNNING) || 
+        (activeMove.position > (mci_GetLastSquareStart() + 
+        (2 * MCI_WALL_EVIDENCE_WINDOW_END_EDGES)))) ? 1u : 0u;
+}
+
+/**
+* Rotate mouse 90 degrees right with some deacceleeration
+*
+* \param None
+* \retval None
+*/
+void mci_TurnRight90DegreesPID(void)
+{
+    (void)mci_TurnByAngle(90, mci_GetTurnProfile());
+}
+
+/**
+* Rotate mouse 90 degrees left with some deacceleration
+*
+* \param None
+* \retval None
+*/
+void mci_TurnLeft90DegreesPID(void)
+{
+    (void)mci_TurnByAngle(-90, mci_GetTurnProfile());
+}
+
+/**
+* Rotate mouse in place by a signed angle
+*
+* The wheel difference is held on a PD loop (wheel gains in settings) whose
+* output is capped by a trapezoid- the cap ramps up by the profile's
+* acceleration, then falls toward the crawl speed over the last edges. The
+* turn only finishes once the error stays inside tolerance for a few ticks,
+* so a missed edge or an overshoot just reverses the wheels until it
+* settles. Common mode drift is driven back to zero to pivot on the spot.
+*
+* \param[in] angleDegrees Angle to turn, positive to the right
+* \param[in] p_profile Rotational speed profile
+* \retval MCI_MOVE_DONE Settled on the target angle
+* \retval MCI_MOVE_TIMEOUT Did not settle in time
+* \retval MCI_MOVE_STALLED Turn aborted, wheels blocked
+*/
+mci_move_status_t mci_TurnByAngle(int32_t angleDegrees, 
+    const mci_turn_profile_t *p_profile)
+{
+    mci_move_status_t status = MCI_MOVE_TIMEOUT;
+    uint32_t elapsedMs = 0u;
+    uint32_t timeoutMs = 0u;
+    uint32_t settledTicks = 0u;
+    int32_t targetDifference = 0;
+    int32_t rotateError = 0;
+    int32_t speedLimit = 0;
+    int32_t rampLimit = 0;
+    int32_t rotate = 0;
+    int32_t forward = 0;
+    int32_t quarterTurns = 0;
+    sf_pid_t rotatePid;
+    sf_pid_t driftPid;
+    const mci_settings_t *p_settings = mci_GetSettings();
+    
+    sf_InitPid(&rotatePid, p_settings->wheelGains.kp, 
+        p_settings->wheelGains.ki, p_settings->wheelGains.kd,
+        -MCI_MAXIMUM_SPEED, MCI_MAXIMUM_SPEED);
+    sf_InitPid(&driftPid, p_settings->wheelGains.kp, 
+        p_settings->wheelGains.ki, p_settings->wheelGains.kd,
+        -p_profile->minimumSpeed, p_profile->minimumSpeed);
+    
+    /* each wheel covers the 90 degree count per quarter turn */
+    if (angleDegrees >= 0)
+    {
+        targetDifference = (2 * angleDegrees * 
+            MCI_WHEEL_MOTOR_EDGES_PER_90_DEGREE_TURN_RIGHT_PID) / 90;
+    }
+    else
+    {
+        targetDifference = (2 * angleDegrees * 
+            MCI_WHEEL_MOTOR_EDGES_PER_90_DEGREE_TURN_LEFT_PID) / 90;
+    }
+    timeoutMs = MCI_TURN_TIMEOUT_MS_PER_90_DEGREES * 
+        (((uint32_t)abs(angleDegrees) + 89u) / 90u);
+    
+    /* reset encoder counts */
+    mci_ClearEncoderCounts();
+    mci_ResetStallMonitor();
+    drivenLeftSpeed = 0;
+    drivenRightSpeed = 0;
+    
+    while (elapsedMs < timeoutMs)
+    {
+        mci_WaitForControlTick();
+        mci_UpdateOdometry();
+        elapsedMs += MCI_CONTROL_TICK_MS;
+        
+        if (mci_CheckStall(drivenLeftSpeed, drivenRightSpeed) != 
+            MCI_STALL_NONE)
+        {
+            status = MCI_MOVE_STALLED;
+            break;
+        }
+        
+        /* right turns drive the left wheel forward, the right backward */
+        rotateError = targetDifference - 
+            ((int32_t)mhi_GetEncoder1EdgeCount() - 
+            (int32_t)mhi_GetEncoder2EdgeCount());
+        
+        if (abs(rotateError) <= MCI_TURN_TOLERANCE_EDGES)
+        {
+            rotate = 0;
+            sf_ResetPid(&rotatePid);
+            
+            /* must stay settled for a few ticks to finish */
+            settledTicks++;
+            if (settledTicks >= MCI_TURN_SETTLE_TICKS)
+            {
+                status = MCI_MOVE_DONE;
+                break;
+            }
+        }
+        else
+        {
+            settledTicks = 0u;
+            
+            /* accelerate up to the peak, then slow down into the target */
+            speedLimit = sf_constrain(speedLimit + p_profile->acceleration,
+                p_profile->maximumSpeed, p_profile->minimumSpeed);
+            /* a profile w/o a deceleration distance stops from full speed */
+            if (p_profile->decelEdges > 0)
+            {
+                rampLimit = p_profile->minimumSpeed + 
+                    (((p_profile->maximumSpeed - p_profile->minimumSpeed) * 
+                    abs(rotateError)) / (2 * p_profile->decelEdges));
+                speedLimit = sf_constrain(speedLimit, rampLimit, 
+                    p_profile->minimumSpeed);
+            }
+            
+            /* keep the crawl speed so the wheels never stall short */
+            mci_SchedulePid(&rotatePid, MCI_MANOEUVRE_PIVOT, speedLimit, 
+                &p_settings->wheelGains);
+            rotate = sf_constrain(sf_UpdatePid(&rotatePid, rotateError), 
+                speedLimit, -speedLimit);
+            /* w/ no controller output the crawl goes toward the target */
+            if (rotate == 0)
+                rotate = (rotateError > 0) ? p_profile->minimumSpeed : 
+                    -p_profile->minimumSpeed;
+            else if ((rotate > 0) && (rotate < p_profile->minimumSpeed))
+                rotate = p_profile->minimumSpeed;
+            else if ((rotate < 0) && (rotate > -p_profile->minimumSpeed))
+                rotate = -p_profile->minimumSpeed;
+        }
+        
+        /* pivot about the wheel axis center */
+        forward = -sf_UpdatePid(&driftPid, 
+            (int32_t)mhi_GetEncoder1EdgeCount() + 
+            (int32_t)mhi_GetEncoder2EdgeCount());
+        
+        mci_DriveWheels(forward + rotate, forward - rotate);
+    }
+    
+    /* clear encoder edge counts and set motor speeds to 0 */
+    mhi_StopWheelMotor1();
+    mhi_StopWheelMotor2();
+    mci_ClearEncoderCounts();
+    
+    /* rotate the wall presences for each whole quarter turn */
+    if ((status != MCI_MOVE_STALLED) && ((angleDegrees % 90) == 0))
+    {
+        for (quarterTurns = angleDegrees / 90; quarterTurns > 0; 
+            quarterTurns--)
+        {
+            mci_UpdateWallPresenceRightTurn();
+        }
+        for (; quarterTurns < 0; quarterTurns++)
+        {
+            mci_UpdateWallPresenceLeftTurn();
+        }
+    }
+    
+#if defined(DEBUG_MCI_MOVEMENT_ENABLE) && (DEBUG_MCI_MOVEMENT_ENABLE == 1)
+    if (status == MCI_MOVE_TIMEOUT)
+    {
+        mhi_PrintString("Turn timeout, edges off: ");
+        mhi_PrintInt((unsigned long)abs(rotateError));
+        mhi_PrintString("\r\n");
+    }
+#endif /* DEBUG_MCI_MOVEMENT_ENABLE */
+    
+    return status;
+}
 
+/**
+* Get the in place turn profile for the current downforce state
+*
+* \param None
+* \retval turn profile w/ higher limits while the fan is on and every IR
+*         sensor is healthy
+*/
+const mci_turn_profile_t *mci_GetTurnProfile(void)
+{
+    if ((mci_GetDownforce() == MCI_DOWNFORCE_ON) && 
+        (mci_GetFailedIrSensors() == 0u))
+        return &downforceTurnProfile;
+    else
+        return &searchTurnProfile;
+}
+
+/**
+* Drive both wheel motors w/ signed speeds
+*
+* Speeds are constrained to the PWM range and negative speeds spin the wheel
+* backward. Each wheel's duty cycle table makes the speeds linear.
+*
+* \param[in] leftSpeed Signed wheel speed for the left wheel (motor 1)
+* \param[in] rightSpeed Signed wheel speed for the right wheel (motor 2)
+* \retval None
+*/
+void mci_DriveWheels(int32_t leftSpeed, int32_t rightSpeed)
+{
+    int16_t leftDuty = 0;
+    int16_t rightDuty = 0;
+    
+    leftSpeed = sf_constrain(leftSpeed, MCI_MAXIMUM_SPEED, -MCI_MAXIMUM_SPEED);
+    rightSpeed = sf_constrain(rightSpeed, MCI_MAXIMUM_SPEED, -MCI_MAXIMUM_SPEED);
+    drivenLeftSpeed = leftSpeed;
+    drivenRightSpeed = rightSpeed;
+    
+    leftDuty = (int16_t)mci_ConvertSpeedToDuty(MCI_WHEEL_LEFT, 
+        (uint32_t)abs(leftSpeed));
+    rightDuty = (int16_t)mci_ConvertSpeedToDuty(MCI_WHEEL_RIGHT, 
+        (uint32_t)abs(rightSpeed));
+    
+    mhi_SetWheelSpeeds((leftSpeed < 0) ? -leftDuty : leftDuty, 
+        (rightSpeed < 0) ? -rightDuty : rightDuty);
+}
 
 /*----------------------------------------------------------------------------*/
 /*                           Local Shared Functions                           */
@@ -1246,4 +1338,289 @@ void mci_TurnLeft90DegreesPID(void){
 /*----------------------------------------------------------------------------*/
 /*                         Private (Static) Functions                         */
 /*----------------------------------------------------------------------------*/
-/* None */
+/**
+* Stop the straight move in progress
+*
+* \param None
+* \retval None
+*/
+static void mci_FinishMove(void)
+{
+    /* clear encoder edge counts and set motor speeds to 0 */
+    mhi_StopWheelMotor1();
+    mhi_StopWheelMotor2();
+    mci_ClearEncoderCounts();
+    
+    /* win back acceleration after a move w/ good traction */
+    if (!activeMove.slipSeen)
+    {
+        accelerationLimit = sf_constrain(accelerationLimit + 
+            MCI_MOVE_ACCELERATION_RECOVERY, mci_GetAccelerationMaximum(),
+            MCI_MOVE_ACCELERATION_MINIMUM);
+    }
+    
+    activeMove.status = MCI_MOVE_DONE;
+}
+
+/**
+* Get the straight move acceleration ceiling for the current downforce state
+*
+* \param None
+* \retval acceleration limit in speed per control tick
+*/
+static int32_t mci_GetAccelerationMaximum(void)
+{
+    if (mci_GetDownforce() == MCI_DOWNFORCE_ON)
+        return MCI_MOVE_ACCELERATION_MAXIMUM_DOWNFORCE;
+    else
+        return MCI_MOVE_ACCELERATION_MAXIMUM;
+}
+
+/**
+* Snap odometry to a wall post edge and shift the move target to match
+*
+* \param[in] edge Side wall transition seen this control tick
+* \param[in,out] p_targetPosition Move target in summed wheel edges
+* \retval None
+*/
+static void mci_CorrectPositionAtWallEdge(mci_wall_edge_t edge, 
+    int32_t *p_targetPosition)
+{
+    int32_t offsetMm = 0;
+    sf_q16_t correctionMm = 0;
+    
+    if (edge == MCI_WALL_EDGE_WALL_TO_GAP)
+        offsetMm = MCI_WALL_EDGE_WALL_TO_GAP_OFFSET_MM;
+    else if (edge == MCI_WALL_EDGE_GAP_TO_WALL)
+        offsetMm = MCI_WALL_EDGE_GAP_TO_WALL_OFFSET_MM;
+    else
+        return;
+    
+    /* further along than the encoders said means less distance to go */
+    if (mci_SnapPositionAlongHeading(offsetMm, MCI_WALL_EDGE_SNAP_TOLERANCE_MM,
+        &correctionMm))
+    {
+        *p_targetPosition -= mci_ConvertMmToEdges(correctionMm) * 2;
+    }
+}
+
+/**
+* Calculate side wall centering error for the straight move controller
+*
+* \param[in] policy Which wall combinations to center off
+* \param[in] leftWall Left wall presence for this control tick
+* \param[in] rightWall Right wall presence for this control tick
+* \param[in] leftReading Left IR sensor reading
+* \param[in] rightReading Right IR sensor reading
+* \param[out] p_error Centering error- positive steers the mouse right
+* \retval 1 Centering error is valid
+* \retval 0 No wall to center off under the given policy
+*/
+static uint32_t mci_GetCenteringError(mci_centering_policy_t policy, 
+    mci_wall_presence_t leftWall, mci_wall_presence_t rightWall,
+    uint32_t leftReading, uint32_t rightReading, int32_t *p_error)
+{
+    int32_t errorSensorLeft = 0;
+    int32_t errorSensorRight = 0;
+    uint32_t valid = 0u;
+    
+    if (policy == MCI_CENTERING_NONE)
+    {
+        valid = 0u;
+    }
+    else if ((leftWall == MCI_WALL_FOUND) && (rightWall == MCI_WALL_FOUND))
+    {
+        /* center between both walls */
+        if (policy == MCI_CENTERING_ALL_WALLS)
+        {
+            errorSensorLeft = (int32_t)MCI_LEFT_WALL_CENTERED_RAW - 
+                (int32_t)leftReading;
+            errorSensorRight = (int32_t)MCI_RIGHT_WALL_CENTERED_RAW - 
+                (int32_t)rightReading;
+            *p_error = errorSensorRight - errorSensorLeft;
+            valid = 1u;
+        }
+    }
+    else if (leftWall == MCI_WALL_FOUND)
+    {
+        /* reading gets larger as mouse gets closer to the left wall */
+        errorSensorLeft = (int32_t)MCI_LEFT_WALL_CENTERED_RAW - 
+            (int32_t)leftReading;
+        if (errorSensorLeft > 0)
+        {
+            errorSensorLeft *= MCI_MOVE_SINGLE_WALL_FAR_GAIN;
+        }
+        *p_error = -errorSensorLeft * MCI_MOVE_SINGLE_WALL_GAIN;
+        valid = 1u;
+    }
+    else if (rightWall == MCI_WALL_FOUND)
+    {
+        /* reading gets larger as mouse gets closer to the right wall */
+        errorSensorRight = (int32_t)MCI_RIGHT_WALL_CENTERED_RAW - 
+            (int32_t)rightReading;
+        if (errorSensorRight > 0)
+        {
+            errorSensorRight *= MCI_MOVE_SINGLE_WALL_FAR_GAIN;
+        }
+        *p_error = errorSensorRight * MCI_MOVE_SINGLE_WALL_GAIN;
+        valid = 1u;
+    }
+    
+    return valid;
+}
+
+/**
+* Hand the stop of a straight to the front wall or back for one tick
+*
+* The wall must read in range for MCI_APPROACH_IN_RANGE_TICKS ticks in a row
+* before the approach takes over, so one spurious reading does not. Once
+* approaching, a wall that falls below MCI_APPROACH_OUT_OF_RANGE_RAW hands
+* the stop back to the target distance.
+*
+* \param[in] ir1Reading Left front sensor reading
+* \param[in] ir4Reading Right front sensor reading
+* \retval None
+*/
+static void mci_UpdateFrontWallApproach(uint32_t ir1Reading, 
+    uint32_t ir4Reading)
+{
+    uint32_t frontReading = (ir1Reading + ir4Reading) / 2u;
+    
+    if (activeMove.approachingWall)
+    {
+        if (frontReading < MCI_APPROACH_OUT_OF_RANGE_RAW)
+        {
+            activeMove.approachingWall = 0u;
+            activeMove.approachInRangeTicks = 0u;
+            activeMove.approachTicks = 0u;
+            activeMove.approachSettledTicks = 0u;
+        }
+        return;
+    }
+    
+    if (frontReading >= MCI_APPROACH_IN_RANGE_RAW)
+    {
+        activeMove.approachInRangeTicks++;
+        if (activeMove.approachInRangeTicks >= MCI_APPROACH_IN_RANGE_TICKS)
+        {
+            activeMove.approachingWall = 1u;
+        }
+    }
+    else
+    {
+        activeMove.approachInRangeTicks = 0u;
+    }
+}
+
+/**
+* Regulate base speed on the distance to the front wall for one tick
+*
+* Base speed only ever comes down from what the move was doing, so the mouse
+* can come in fast and still stop at the square center. Overshoot backs the
+* mouse up at crawl speed. On settling, the pose is snapped like after a
+* front wall alignment.
+*
+* \param[in] ir1Reading Left front sensor reading
+* \param[in] ir4Reading Right front sensor reading
+* \retval MCI_MOVE_DONE Settled at the center distance
+* \retval MCI_MOVE_TIMEOUT Never settled
+* \retval MCI_MOVE_RUNNING Still approaching
+*/
+static mci_move_status_t mci_ApproachFrontWall(uint32_t ir1Reading, 
+    uint32_t ir4Reading)
+{
+    int32_t frontMm = 0;
+    int32_t errorMm = 0;
+    int32_t speed = 0;
+    
+    activeMove.approachTicks++;
+    if (activeMove.approachTicks >= MCI_APPROACH_TIMEOUT_TICKS)
+    {
+        return MCI_MOVE_TIMEOUT;
+    }
+    
+    /* distance left to the center reading along the front sensor beams */
+    frontMm = ((int32_t)mci_ConvertReadingToMm(MCI_IR_SENSOR_LEFT_FRONT, 
+        ir1Reading) + (int32_t)mci_ConvertReadingToMm(
+        MCI_IR_SENSOR_RIGHT_FRONT, ir4Reading)) / 2;
+    errorMm = frontMm - (int32_t)mci_ConvertReadingToMm(
+        MCI_IR_SENSOR_LEFT_FRONT, MCI_FRONT_WALL_CENTERED_RAW);
+    
+    if (abs(errorMm) <= MCI_APPROACH_TOLERANCE_MM)
+    {
+        activeMove.baseSpeed = 0;
+        activeMove.approachSettledTicks++;
+        if (activeMove.approachSettledTicks >= MCI_APPROACH_SETTLE_TICKS)
+        {
+            mci_SnapPositionAlongHeading(0, MCI_MAZE_SQUARE_LENGTH_MM, 0);
+            if ((abs((int32_t)ir1Reading - (int32_t)ir4Reading) <= 
+                MCI_ALIGN_ANGLE_TOLERANCE) && 
+                ((mci_GetFailedIrSensors() & MCI_IR_FAILED_FRONT_PAIR) == 0u))
+            {
+                mci_SnapHeadingToMaze();
+            }
+            return MCI_MOVE_DONE;
+        }
+        return MCI_MOVE_RUNNING;
+    }
+    
+    activeMove.approachSettledTicks = 0u;
+    
+    /* slow down only, never below crawl speed while out of tolerance */
+    speed = sf_Q16MulInt(MCI_APPROACH_KP_DISTANCE, errorMm);
+    if (speed > 0)
+    {
+        speed = sf_constrain(speed, activeMove.baseSpeed, 
+            MCI_APPROACH_CRAWL_SPEED);
+        if (speed < MCI_APPROACH_CRAWL_SPEED)
+            speed = MCI_APPROACH_CRAWL_SPEED;
+    }
+    else
+    {
+        speed = -MCI_APPROACH_CRAWL_SPEED;
+    }
+    activeMove.baseSpeed = speed;
+    
+    return MCI_MOVE_RUNNING;
+}
+
+/**
+* Get where the last square of the straight move starts
+*
+* \param None
+* \retval Start of the last square in edges summed over both wheels
+*/
+static int32_t mci_GetLastSquareStart(void)
+{
+    int32_t squareStart = 0;
+    
+    /* positions are edges summed over both wheels */
+    squareStart = activeMove.targetPosition - 
+        (2 * MCI_WHEEL_MOTOR_EDGES_PER_MAZE_SQUARE);
+    if (squareStart < 0)
+    {
+        squareStart = 0;
+    }
+    
+    return squareStart;
+}
+
+/**
+* Check whether the straight move is inside the side wall evidence window
+*
+* The window sits in the last square of the move, measured from where that
+* square starts, so it follows edge corrections to the target.
+*
+* \param None
+* \retval 1 Side wall readings of the last square may vote
+* \retval 0 Outside the window
+*/
+static uint32_t mci_IsInWallEvidenceWindow(void)
+{
+    int32_t squareStart = mci_GetLastSquareStart();
+    
+    return ((activeMove.position >= 
+        squareStart + (2 * MCI_WALL_EVIDENCE_WINDOW_START_EDGES)) && 
+        (activeMove.position <= 
+        squareStart + (2 * MCI_WALL_EVIDENCE_WINDOW_END_EDGES))) ? 1u : 0u;
+}
@@ -20,8 +20,11 @@
 /*----------------------------------------------------------------------------*/
 #define MCI_TURN_SPEED            (140)
 #define MCI_FORWARD_FAST_SPEED    (140)
-/* minimum speed required for mouse to move */
+/* minimum duty cycle required for mouse to move, the floor of the */
+/* uncalibrated wheel tables */
 #define MCI_MINIMUM_SPEED         (140)
+/* maximum wheel motor duty cycle, also top linear wheel speed */
+#define MCI_MAXIMUM_SPEED         (255)
 
 /* ServoCity's N20 4900RPM Gear Motor: 60.8077 countable events per rev */
 /* and 3D printed gear ratio of 44:13. (44/13)*60.8077 = 205.81 */
@@ -49,6 +52,8 @@
         //MCI_WHEEL_MOTOR_EDGES_PER_MAZE_SQUARE_REAL_MAZE
 
 #define MCI_WHEEL_MOTOR_EDGES_PER_MAZE_SQR_CONTINOUS (89)
+/* center to center of a diagonally adjacent maze square, found experimentally */
+#define MCI_WHEEL_MOTOR_EDGES_PER_DIAGONAL_MOVE      (112)
 /* c = pi*d; pi*100mm = 295.3mm */
 /* (edges/rev)/(wheel circumference) = edges/mm; (edges/mm)*(c/4) = */
 /* edges/90deg turn; (52/103mm)*(295.3mm/4) = 37 edges/maze square */
@@ -65,6 +70,84 @@
 #define  MCI_WHEEL_MOTOR_EDGES_PER_45_DEGREE_TURN_RIGHT (MCI_WHEEL_MOTOR_EDGES_PER_90_DEGREE_TURN_RIGHT/2)
 #define  MCI_WHEEL_MOTOR_EDGES_PER_45_DEGREE_TURN_LEFT (MCI_WHEEL_MOTOR_EDGES_PER_90_DEGREE_TURN_LEFT/2)
 
+/* result of a closed loop movement */
+typedef enum
+{
+    MCI_MOVE_DONE = 0u,     /* target reached */
+    MCI_MOVE_TIMEOUT,       /* gave up before the target was reached */
+    MCI_MOVE_STALLED,       /* aborted- wheels blocked, e.g. by a wall */
+    MCI_MOVE_RUNNING        /* started, not finished yet */
+} mci_move_status_t;
+
+/* manoeuvre types, each w/ its own gain schedule */
+typedef enum
+{
+    MCI_MANOEUVRE_STRAIGHT = 0u,    /* along a maze direction */
+    MCI_MANOEUVRE_DIAGONAL,         /* across squares at 45 degrees */
+    MCI_MANOEUVRE_PIVOT,            /* in place turn */
+    MCI_MANOEUVRE_ARC,              /* turn while moving forward */
+    MCI_MANOEUVRE_COUNT
+} mci_manoeuvre_t;
+
+/* side wall centering policy for straight moves */
+typedef enum
+{
+    MCI_CENTERING_NONE = 0u,       /* hold heading w/ encoders only */
+    MCI_CENTERING_SINGLE_WALL,     /* center off a lone side wall only */
+    MCI_CENTERING_ALL_WALLS        /* center off one or both side walls */
+} mci_centering_policy_t;
+
+/* stop condition for straight moves */
+typedef enum
+{
+    MCI_STOP_AT_DISTANCE = 0u,
+    MCI_STOP_AT_DISTANCE_OR_FRONT_WALL  /* stop centered on a wall in range */
+} mci_stop_condition_t;
+
+/* longitudinal correction from side wall post edges for straight moves */
+typedef enum
+{
+    MCI_EDGE_CORRECTION_OFF = 0u,
+    MCI_EDGE_CORRECTION_ON          /* only valid along a maze direction */
+} mci_edge_correction_t;
+
+/* speed profile for straight moves (wheel speeds 0~255) */
+typedef struct
+{
+    int32_t cruiseSpeed;    /* base speed for most of the move */
+    int32_t endSpeed;       /* base speed reached at the target */
+    int32_t decelEdges;     /* edges before the target to start slowing */
+} mci_speed_profile_t;
+
+/* rotational speed profile for in place turns (wheel speeds 0~255) */
+typedef struct
+{
+    int32_t maximumSpeed;   /* peak wheel speed while rotating */
+    int32_t minimumSpeed;   /* crawl speed that still turns the mouse */
+    int32_t acceleration;   /* wheel speed increase per control tick */
+    int32_t decelEdges;     /* edges per wheel before the target to slow */
+} mci_turn_profile_t;
+
+/* turn profile used while searching the maze */
+#define MCI_TURN_PROFILE_SEARCH \
+    {.maximumSpeed = 140, .minimumSpeed = 60, .acceleration = 20, \
+    .decelEdges = 12}
+/* turn profile used while the vacuum fan holds the mouse down */
+#define MCI_TURN_PROFILE_DOWNFORCE \
+    {.maximumSpeed = 200, .minimumSpeed = 60, .acceleration = 35, \
+    .decelEdges = 14}
+
+/* straight move parameters for the shared move engine */
+typedef struct
+{
+    int32_t distanceEdges;                      /* edges per wheel to move */
+    mci_manoeuvre_t manoeuvre;                  /* straight or diagonal */
+    mci_speed_profile_t profile;
+    mci_centering_policy_t centering;
+    mci_stop_condition_t stopCondition;
+    mci_wall_update_availability_t wallUpdates; /* gather side wall evidence */
+    mci_edge_correction_t edgeCorrection;
+} mci_move_params_t;
 
 /*----------------------------------------------------------------------------*/
 /*                              Global Variables                              */
@@ -76,17 +159,27 @@
 /*----------------------------------------------------------------------------*/
 void mci_MoveForward1Revolution(void);
 void mci_MoveForward1MazeSquarePid(void);
+void mci_StartMoveForward1MazeSquarePid(void);
 void mci_TurnRight90Degrees(void);
 void mci_TurnLeft90Degrees(void);
-void mci_AdjustToFrontWall(void);
+mci_move_status_t mci_AdjustToFrontWall(void);
+mci_move_status_t mci_RecalibrateOnBackWall(void);
 void mci_TurnRight45Degrees(void);
 void mci_TurnLeft45Degrees(void);
 void mci_MoveCentertoCenterPid(void);
 void mci_MoveForwardNSquares(int n);
 void mci_TurnRight90DegreesPID(void);
 void mci_TurnLeft90DegreesPID(void);
+mci_move_status_t mci_TurnByAngle(int32_t angleDegrees, 
+    const mci_turn_profile_t *p_profile);
+const mci_turn_profile_t *mci_GetTurnProfile(void);
 void mci_MoveDiagonalLeft(void); 
 void mci_MoveDiagonalRight(void);
+mci_move_status_t mci_MoveForward(const mci_move_params_t *p_params);
+void mci_StartMove(const mci_move_params_t *p_params);
+mci_move_status_t mci_PollMove(void);
+uint32_t mci_CheckMoveWallsLatched(void);
+void mci_DriveWheels(int32_t leftSpeed, int32_t rightSpeed);
 
 mci_wall_presence_t mci_CheckLeftWallMoveForwardPid(void);
 mci_wall_presence_t mci_CheckRightWallMoveForwardPid(void);
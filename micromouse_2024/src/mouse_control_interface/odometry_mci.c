@@ -0,0 +1,614 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : odometry_mci.c
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-04-13
+* Purpose         : mouse control interface layer
+*
+* This is the source file for mouse odometry under the mouse control
+* interface.
+*
+* The mouse control interface uses the mouse hardware interface to define high
+* level micromouse functionality.
+*-----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "micromouse_dimensions.h"
+#include "shared_functions/fixedpoint_sf.h"
+#include "mouse_hardware_interface/interrupts_mhi.h"
+#include "mouse_control_interface/walldetection_mci.h"
+#include "mouse_control_interface/movement_mci.h"
+#include "mouse_control_interface/odometry_mci.h"
+#include "mouse_control_interface/settings_mci.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+/* distance per wheel encoder edge, calibrated against one maze square */
+#define MCI_ODOMETRY_MM_PER_EDGE \
+    ((sf_q16_t)((MCI_MAZE_SQUARE_LENGTH_MM * SF_Q16_ONE) / \
+    MCI_WHEEL_MOTOR_EDGES_PER_MAZE_SQUARE))
+
+/* heading change per edge of left/right wheel difference, calibrated against
+   one 90 degree pivot (both wheels turn the same edge count in opposite
+   directions). Kept w/ 16 extra fraction bits of binary angle */
+#define MCI_ODOMETRY_ANGLE_PER_EDGE \
+    ((int32_t)(((int32_t)SF_ANGLE_90_DEGREES * SF_Q16_ONE) / \
+    (2 * MCI_WHEEL_MOTOR_EDGES_PER_90_DEGREE_TURN_RIGHT_PID)))
+
+/* control ticks of wheel edges kept for slip detection */
+#define MCI_SLIP_WINDOW_TICKS           (4u)
+
+/* wheel speed change over the window no traction limited mouse can make-
+   one edge per tick is about 3.7 mm per 8 ms */
+#define MCI_SLIP_ACCELERATION_EDGES     (2)
+
+/* left/right edge difference over the window a straight move cannot make */
+#define MCI_SLIP_DISAGREEMENT_EDGES     (3)
+
+/* travel between side wall heading samples, edges summed over both wheels-
+   about 30 mm, long enough for the reading change to beat sensor noise */
+#define MCI_WALL_HEADING_SAMPLE_EDGES   (16)
+
+/* side readings follow raw = 896 * 0.98^mm along the 45 degree ray, so
+   d(mm) = 49.5 * d(raw) / raw. Times cos 45 gives the lateral distance */
+#define MCI_WALL_HEADING_LATERAL_MM_PER_LOG_RAW    SF_Q16_FROM_FLOAT(35.0f)
+
+/* binary angle per radian, 65536 / (2 * pi) */
+#define MCI_ANGLE_PER_RADIAN            (10430)
+
+/* larger angles come from a post edge or a gap in the wall, not heading */
+#define MCI_WALL_HEADING_MAXIMUM        ((int32_t)SF_ANGLE_FROM_DEGREES(15))
+
+/*----------------------------------------------------------------------------*/
+/*                               Debug Switches                               */
+/*----------------------------------------------------------------------------*/
+/* 1 = Enable Debug Trace Output */
+#define DEBUG_MCI_ODOMETRY_ENABLE    (1)
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+static sf_q16_t poseXMm = 0;
+static sf_q16_t poseYMm = 0;
+static uint32_t poseHeading = 0u;   /* binary angle in upper 16 bits */
+
+static int32_t lastLeftEdgeCount = 0;
+static int32_t lastRightEdgeCount = 0;
+static int32_t lastLeftDelta = 0;
+static int32_t lastRightDelta = 0;
+
+/* pose before the last odometry step, to redo it if a wheel slipped */
+static sf_q16_t lastPoseXMm = 0;
+static sf_q16_t lastPoseYMm = 0;
+static uint32_t lastPoseHeading = 0u;
+
+/* last wheel edges per control tick, oldest first */
+static int32_t leftSlipWindow[MCI_SLIP_WINDOW_TICKS];
+static int32_t rightSlipWindow[MCI_SLIP_WINDOW_TICKS];
+static uint32_t slipWindowTicks = 0u;
+static uint32_t slipEventCount = 0u;
+static uint32_t slipDisagreeing = 0u;
+
+/* side readings and travel at the last wall heading sample */
+static uint32_t wallHeadingLeftReading = 0u;
+static uint32_t wallHeadingRightReading = 0u;
+static int32_t wallHeadingTravel = 0;
+
+/*----------------------------------------------------------------------------*/
+/*                    Private (Static) Function Prototype                     */
+/*----------------------------------------------------------------------------*/
+static void mci_IntegrateWheelDeltas(int32_t leftDelta, int32_t rightDelta);
+static uint32_t mci_GetWallClosingMm(uint32_t reading, uint32_t lastReading,
+    uint32_t threshold, sf_q16_t *p_closingMm);
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+/**
+* Put the mouse at the center of the start cell facing north
+*
+* \param None
+* \retval None
+*/
+void mci_ResetPose(void)
+{
+    mci_UpdateOdometry();
+    
+    poseXMm = 0;
+    poseYMm = 0;
+    poseHeading = 0u;
+    lastLeftDelta = 0;
+    lastRightDelta = 0;
+}
+
+/**
+* Overwrite the pose estimate
+*
+* \param[in] p_pose New pose
+* \retval None
+*/
+void mci_SetPose(const mci_pose_t *p_pose)
+{
+    mci_UpdateOdometry();
+    
+    poseXMm = p_pose->xMm;
+    poseYMm = p_pose->yMm;
+    poseHeading = (uint32_t)p_pose->heading << 16;
+}
+
+/**
+* Get the current pose estimate
+*
+* \param[out] p_pose Current pose
+* \retval None
+*/
+void mci_GetPose(mci_pose_t *p_pose)
+{
+    p_pose->xMm = poseXMm;
+    p_pose->yMm = poseYMm;
+    p_pose->heading = (sf_angle_t)(poseHeading >> 16);
+}
+
+/**
+* Get the current heading estimate
+*
+* \param None
+* \retval heading clockwise from north as a binary angle
+*/
+sf_angle_t mci_GetHeading(void)
+{
+    return (sf_angle_t)(poseHeading >> 16);
+}
+
+/**
+* Overwrite the heading estimate, leaving position unchanged
+*
+* \param[in] heading New heading clockwise from north
+* \retval None
+*/
+void mci_SetHeading(sf_angle_t heading)
+{
+    mci_UpdateOdometry();
+    
+    poseHeading = (uint32_t)heading << 16;
+}
+
+/**
+* Integrate wheel encoder movement since the last update into the pose
+*
+* Call once per control tick from any loop that moves the wheels.
+*
+* \param None
+* \retval None
+*/
+void mci_UpdateOdometry(void)
+{
+    int32_t leftEdgeCount = (int32_t)mhi_GetEncoder1EdgeCount();
+    int32_t rightEdgeCount = (int32_t)mhi_GetEncoder2EdgeCount();
+    int32_t leftDelta = leftEdgeCount - lastLeftEdgeCount;
+    int32_t rightDelta = rightEdgeCount - lastRightEdgeCount;
+    
+    lastLeftEdgeCount = leftEdgeCount;
+    lastRightEdgeCount = rightEdgeCount;
+    lastLeftDelta = leftDelta;
+    lastRightDelta = rightDelta;
+    
+    lastPoseXMm = poseXMm;
+    lastPoseYMm = poseYMm;
+    lastPoseHeading = poseHeading;
+    
+    mci_IntegrateWheelDeltas(leftDelta, rightDelta);
+}
+
+/**
+* Clear both wheel encoder edge counts without losing odometry
+*
+* Movement functions use this instead of clearing the encoders directly so
+* that the pose keeps counting across moves.
+*
+* \param None
+* \retval None
+*/
+void mci_ClearEncoderCounts(void)
+{
+    mci_UpdateOdometry();
+    
+    mhi_ClearEncoder1EdgeCount();
+    mhi_ClearEncoder2EdgeCount();
+    lastLeftEdgeCount = 0;
+    lastRightEdgeCount = 0;
+}
+
+/**
+* Get the wheel encoder edges counted by the last odometry update
+*
+* \param[out] p_leftEdges Signed left wheel edges, positive forward
+* \param[out] p_rightEdges Signed right wheel edges, positive forward
+* \retval None
+*/
+void mci_GetLastWheelDeltas(int32_t *p_leftEdges, int32_t *p_rightEdges)
+{
+    *p_leftEdges = lastLeftDelta;
+    *p_rightEdges = lastRightDelta;
+}
+
+/**
+* Round the heading to the nearest maze direction
+*
+* Use when the mouse is known to be square to a wall.
+*
+* \param None
+* \retval None
+*/
+void mci_SnapHeadingToMaze(void)
+{
+    mci_UpdateOdometry();
+    
+    poseHeading = (poseHeading + ((uint32_t)SF_ANGLE_90_DEGREES << 15)) & 
+        ((uint32_t)0xC000 << 16);
+}
+
+/**
+* Round the position along the heading to a known point in the cell
+*
+* Only the coordinate along the nearest maze direction changes; the
+* sideways coordinate is left alone. Nothing changes if the pose is further
+* than the tolerance from the known point.
+*
+* \param[in] offsetMm Known point ahead of the cell center, 0 for the center
+* \param[in] toleranceMm Largest correction to accept
+* \param[out] p_correctionMm Correction applied along the heading, may be 0
+* \retval 1 Position snapped
+* \retval 0 Outside tolerance, position unchanged
+*/
+uint32_t mci_SnapPositionAlongHeading(int32_t offsetMm, int32_t toleranceMm,
+    sf_q16_t *p_correctionMm)
+{
+    sf_angle_t direction = 0u;
+    sf_q16_t *p_coordinate = 0;
+    int32_t pitch = SF_Q16_FROM_INT(MCI_MAZE_SQUARE_LENGTH_MM);
+    int32_t offset = 0;
+    int32_t cells = 0;
+    sf_q16_t correction = 0;
+    uint32_t snapped = 0u;
+    
+    mci_UpdateOdometry();
+    
+    /* nearest maze direction picks the axis and which way the offset goes */
+    direction = (sf_angle_t)((mci_GetHeading() + (SF_ANGLE_90_DEGREES / 2u)) & 
+        0xC000u);
+    p_coordinate = ((direction == MCI_HEADING_NORTH) || 
+        (direction == MCI_HEADING_SOUTH)) ? &poseYMm : &poseXMm;
+    offset = ((direction == MCI_HEADING_NORTH) || 
+        (direction == MCI_HEADING_EAST)) ? SF_Q16_FROM_INT(offsetMm) : 
+        SF_Q16_FROM_INT(-offsetMm);
+    
+    /* round to the nearest cell, then move to the known point in it */
+    cells = *p_coordinate - offset;
+    cells = (cells >= 0) ? ((cells + (pitch / 2)) / pitch) : 
+        -((-cells + (pitch / 2)) / pitch);
+    correction = ((cells * pitch) + offset) - *p_coordinate;
+    
+    if ((correction <= SF_Q16_FROM_INT(toleranceMm)) && 
+        (correction >= SF_Q16_FROM_INT(-toleranceMm)))
+    {
+        *p_coordinate += correction;
+        snapped = 1u;
+    }
+    else
+    {
+        correction = 0;
+    }
+    
+    /* report correction as distance along the heading */
+    if (p_correctionMm)
+    {
+        *p_correctionMm = ((direction == MCI_HEADING_NORTH) || 
+            (direction == MCI_HEADING_EAST)) ? correction : -correction;
+    }
+    
+    return snapped;
+}
+
+/**
+* Convert a distance to the wheel encoder edges that cover it
+*
+* \param[in] distanceMm Distance in Q16.16 mm
+* \retval encoder edges per wheel, rounded to nearest
+*/
+int32_t mci_ConvertMmToEdges(sf_q16_t distanceMm)
+{
+    if (distanceMm >= 0)
+        return (distanceMm + (MCI_ODOMETRY_MM_PER_EDGE / 2)) / 
+            MCI_ODOMETRY_MM_PER_EDGE;
+    else
+        return -((-distanceMm + (MCI_ODOMETRY_MM_PER_EDGE / 2)) / 
+            MCI_ODOMETRY_MM_PER_EDGE);
+}
+
+/**
+* Clear slip detection history- call when a straight move starts
+*
+* \param None
+* \retval None
+*/
+void mci_ResetSlipDetection(void)
+{
+    slipWindowTicks = 0u;
+    slipDisagreeing = 0u;
+}
+
+/**
+* Check the last odometry step for wheel slip and correct the pose
+*
+* Call once per control tick right after mci_UpdateOdometry(), in straight
+* moves only. A wheel slipping on the floor spins faster than the mouse
+* moves, so if either wheel's speed jumps faster than traction allows the
+* last step is redone w/ the slower wheel for both.
+*
+* The wheels also disagree while the move steers back onto its heading, so
+* disagreement is only reported, once as it starts, and the pose is kept.
+*
+* \param[out] p_slippedEdges Edges both wheels counted past the redone step
+* \retval MCI_SLIP_NONE or MCI_SLIP_x flags for what was seen
+*/
+uint32_t mci_DetectWheelSlip(int32_t *p_slippedEdges)
+{
+    uint32_t slip = MCI_SLIP_NONE;
+    int32_t leftSum = 0;
+    int32_t rightSum = 0;
+    int32_t trustedDelta = 0;
+    uint32_t i = 0u;
+    
+    *p_slippedEdges = 0;
+    
+    /* shift the newest step into the window */
+    for (i = 1u; i < MCI_SLIP_WINDOW_TICKS; i++)
+    {
+        leftSlipWindow[i - 1u] = leftSlipWindow[i];
+        rightSlipWindow[i - 1u] = rightSlipWindow[i];
+    }
+    leftSlipWindow[MCI_SLIP_WINDOW_TICKS - 1u] = lastLeftDelta;
+    rightSlipWindow[MCI_SLIP_WINDOW_TICKS - 1u] = lastRightDelta;
+    
+    if (slipWindowTicks < MCI_SLIP_WINDOW_TICKS)
+    {
+        slipWindowTicks++;
+        return slip;
+    }
+    
+    /* speed change across the window */
+    if (abs(lastLeftDelta - leftSlipWindow[0]) > MCI_SLIP_ACCELERATION_EDGES)
+    {
+        slip |= MCI_SLIP_LEFT_WHEEL;
+    }
+    if (abs(lastRightDelta - rightSlipWindow[0]) > MCI_SLIP_ACCELERATION_EDGES)
+    {
+        slip |= MCI_SLIP_RIGHT_WHEEL;
+    }
+    
+    for (i = 0u; i < MCI_SLIP_WINDOW_TICKS; i++)
+    {
+        leftSum += leftSlipWindow[i];
+        rightSum += rightSlipWindow[i];
+    }
+    if (abs(leftSum - rightSum) > MCI_SLIP_DISAGREEMENT_EDGES)
+    {
+        if (!slipDisagreeing)
+        {
+            slip |= MCI_SLIP_DISAGREEMENT;
+        }
+        slipDisagreeing = 1u;
+    }
+    else
+    {
+        slipDisagreeing = 0u;
+    }
+    
+    if (slip != MCI_SLIP_NONE)
+    {
+        slipEventCount++;
+    }
+    
+    if ((slip & (MCI_SLIP_LEFT_WHEEL | MCI_SLIP_RIGHT_WHEEL)) != 0u)
+    {
+        /* a slipping wheel over counts- redo the step w/ the slower one */
+        trustedDelta = (abs(lastLeftDelta) < abs(lastRightDelta)) ? 
+            lastLeftDelta : lastRightDelta;
+        poseXMm = lastPoseXMm;
+        poseYMm = lastPoseYMm;
+        poseHeading = lastPoseHeading;
+        mci_IntegrateWheelDeltas(trustedDelta, trustedDelta);
+        *p_slippedEdges = (lastLeftDelta + lastRightDelta) - (2 * trustedDelta);
+        
+        /* keep the bad step from flagging the whole next window */
+        leftSlipWindow[MCI_SLIP_WINDOW_TICKS - 1u] = trustedDelta;
+        rightSlipWindow[MCI_SLIP_WINDOW_TICKS - 1u] = trustedDelta;
+    }
+    
+    return slip;
+}
+
+/**
+* Get the number of slip events seen since reset
+*
+* \param None
+* \retval slip event count
+*/
+uint32_t mci_GetSlipEventCount(void)
+{
+    return slipEventCount;
+}
+
+/**
+* Convert a heading change to the wheel encoder edge difference that turns it
+*
+* \param[in] angle Signed binary angle
+* \retval left minus right wheel edges, rounded to nearest
+*/
+int32_t mci_ConvertAngleToEdges(int32_t angle)
+{
+    if (angle >= 0)
+        return (int32_t)((((int64_t)angle * SF_Q16_ONE) + 
+            (MCI_ODOMETRY_ANGLE_PER_EDGE / 2)) / MCI_ODOMETRY_ANGLE_PER_EDGE);
+    else
+        return -(int32_t)((((int64_t)-angle * SF_Q16_ONE) + 
+            (MCI_ODOMETRY_ANGLE_PER_EDGE / 2)) / MCI_ODOMETRY_ANGLE_PER_EDGE);
+}
+
+/**
+* Start side wall heading estimation over- call when a straight move starts
+*
+* \param[in] travelEdges Travel so far, edges summed over both wheels
+* \param[in] leftReading Left side sensor reading
+* \param[in] rightReading Right side sensor reading
+* \retval None
+*/
+void mci_ResetWallHeadingEstimate(int32_t travelEdges, uint32_t leftReading,
+    uint32_t rightReading)
+{
+    wallHeadingTravel = travelEdges;
+    wallHeadingLeftReading = leftReading;
+    wallHeadingRightReading = rightReading;
+}
+
+/**
+* Estimate heading relative to the side walls from travel along them
+*
+* How fast the distance to a side wall changes over distance travelled gives
+* the angle to that wall, independent of how far off center the mouse is. A
+* wall must be seen at both ends of a sample to count; both walls are
+* averaged. Call once per control tick on straight moves along a maze
+* direction.
+*
+* \param[in] travelEdges Travel so far, edges summed over both wheels
+* \param[in] leftReading Left side sensor reading
+* \param[in] rightReading Right side sensor reading
+* \param[out] p_heading Signed binary angle, positive when angled right of
+*     the walls. Only written when an estimate is made
+* \retval 1 New estimate made
+* \retval 0 Between samples or no usable wall
+*/
+uint32_t mci_EstimateWallHeading(int32_t travelEdges, uint32_t leftReading,
+    uint32_t rightReading, int32_t *p_heading)
+{
+    sf_q16_t travelMm = 0;
+    sf_q16_t leftClosingMm = 0;
+    sf_q16_t rightClosingMm = 0;
+    sf_q16_t lateralMm = 0;
+    uint32_t leftValid = 0u;
+    uint32_t rightValid = 0u;
+    int32_t heading = 0;
+    
+    if ((travelEdges - wallHeadingTravel) < MCI_WALL_HEADING_SAMPLE_EDGES)
+    {
+        return 0u;
+    }
+    
+    travelMm = ((travelEdges - wallHeadingTravel) * 
+        MCI_ODOMETRY_MM_PER_EDGE) / 2;
+    leftValid = mci_GetWallClosingMm(leftReading, wallHeadingLeftReading,
+        MCI_LEFT_SENSOR_READING_THRESHOLD_RAW, &leftClosingMm);
+    rightValid = mci_GetWallClosingMm(rightReading, wallHeadingRightReading,
+        MCI_RIGHT_SENSOR_READING_THRESHOLD_RAW, &rightClosingMm);
+    mci_ResetWallHeadingEstimate(travelEdges, leftReading, rightReading);
+    
+    /* closing on the right wall means the mouse is angled right */
+    if (leftValid && rightValid)
+    {
+        lateralMm = (rightClosingMm - leftClosingMm) / 2;
+    }
+    else if (leftValid)
+    {
+        lateralMm = -leftClosingMm;
+    }
+    else if (rightValid)
+    {
+        lateralMm = rightClosingMm;
+    }
+    else
+    {
+        return 0u;
+    }
+    
+    /* small angle- lateral over travel in radians */
+    heading = (int32_t)(((int64_t)lateralMm * MCI_ANGLE_PER_RADIAN) / 
+        travelMm);
+    if (abs(heading) > MCI_WALL_HEADING_MAXIMUM)
+    {
+        return 0u;
+    }
+    
+    *p_heading = heading;
+    
+    return 1u;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                           Local Shared Functions                           */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                         Private (Static) Functions                         */
+/*----------------------------------------------------------------------------*/
+/**
+* Move the pose by one step of wheel edges
+*
+* \param[in] leftDelta Signed left wheel edges, positive forward
+* \param[in] rightDelta Signed right wheel edges, positive forward
+* \retval None
+*/
+static void mci_IntegrateWheelDeltas(int32_t leftDelta, int32_t rightDelta)
+{
+    int32_t headingChange = 0;
+    sf_q16_t distance = 0;
+    sf_angle_t midHeading = 0u;
+    
+    if ((leftDelta == 0) && (rightDelta == 0))
+        return;
+    
+    /* use the heading halfway through the step for the position update */
+    headingChange = (leftDelta - rightDelta) * MCI_ODOMETRY_ANGLE_PER_EDGE;
+    midHeading = (sf_angle_t)((poseHeading + (headingChange / 2)) >> 16);
+    poseHeading += (uint32_t)headingChange;
+    
+    distance = ((leftDelta + rightDelta) * MCI_ODOMETRY_MM_PER_EDGE) / 2;
+    poseXMm += sf_Q16Mul(distance, sf_Q16Sin(midHeading));
+    poseYMm += sf_Q16Mul(distance, sf_Q16Cos(midHeading));
+}
+
+/**
+* Get how far the mouse closed in on a side wall between two readings
+*
+* \param[in] reading Side sensor reading now
+* \param[in] lastReading Side sensor reading at the last sample
+* \param[in] threshold Wall presence threshold for the sensor
+* \param[out] p_closingMm Lateral distance closed, Q16.16 mm
+* \retval 1 Wall seen at both readings
+* \retval 0 No wall at one of the readings, nothing written
+*/
+static uint32_t mci_GetWallClosingMm(uint32_t reading, uint32_t lastReading,
+    uint32_t threshold, sf_q16_t *p_closingMm)
+{
+    sf_q16_t logChange = 0;
+    
+    if ((reading < threshold) || (lastReading < threshold))
+    {
+        return 0u;
+    }
+    
+    /* relative reading change- readings rise closing in on the wall */
+    logChange = (sf_q16_t)((((int32_t)reading - (int32_t)lastReading) * 
+        SF_Q16_ONE) / (int32_t)((reading + lastReading) / 2u));
+    *p_closingMm = sf_Q16Mul(MCI_WALL_HEADING_LATERAL_MM_PER_LOG_RAW, 
+        logChange);
+    
+    return 1u;
+}
@@ -0,0 +1,73 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : odometry_mci.h
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-04-13
+* Purpose         : mouse control interface layer
+*
+* This is the header file for mouse odometry under the mouse control
+* interface.
+*
+* The pose is kept in the maze frame: origin at the center of the start cell,
+* y pointing the way the mouse faces at start, x to its right, and heading
+* measured clockwise from the y axis.
+*
+* The mouse control interface uses the mouse hardware interface to define high
+* level micromouse functionality.
+*-----------------------------------------------------------------------------*/
+
+#ifndef ODOMETRY_MCI_H_
+#define ODOMETRY_MCI_H_
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+/* headings of the four maze directions */
+#define MCI_HEADING_NORTH    ((sf_angle_t)0x0000)
+#define MCI_HEADING_EAST     ((sf_angle_t)0x4000)
+#define MCI_HEADING_SOUTH    ((sf_angle_t)0x8000)
+#define MCI_HEADING_WEST     ((sf_angle_t)0xC000)
+
+typedef struct
+{
+    sf_q16_t xMm;           /* position right of start, Q16.16 mm */
+    sf_q16_t yMm;           /* position ahead of start, Q16.16 mm */
+    sf_angle_t heading;     /* clockwise from start direction */
+} mci_pose_t;
+
+/* wheel slip flags from mci_DetectWheelSlip() */
+#define MCI_SLIP_NONE             (0x0u)
+#define MCI_SLIP_LEFT_WHEEL       (0x1u)    /* left wheel speed spiked */
+#define MCI_SLIP_RIGHT_WHEEL      (0x2u)    /* right wheel speed spiked */
+#define MCI_SLIP_DISAGREEMENT     (0x4u)    /* wheels started to disagree */
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+void mci_ResetPose(void);
+void mci_SetPose(const mci_pose_t *p_pose);
+void mci_GetPose(mci_pose_t *p_pose);
+sf_angle_t mci_GetHeading(void);
+void mci_SetHeading(sf_angle_t heading);
+void mci_UpdateOdometry(void);
+void mci_ClearEncoderCounts(void);
+void mci_GetLastWheelDeltas(int32_t *p_leftEdges, int32_t *p_rightEdges);
+void mci_SnapHeadingToMaze(void);
+uint32_t mci_SnapPositionAlongHeading(int32_t offsetMm, int32_t toleranceMm,
+    sf_q16_t *p_correctionMm);
+int32_t mci_ConvertMmToEdges(sf_q16_t distanceMm);
+void mci_ResetSlipDetection(void);
+uint32_t mci_DetectWheelSlip(int32_t *p_slippedEdges);
+uint32_t mci_GetSlipEventCount(void);
+int32_t mci_ConvertAngleToEdges(int32_t angle);
+void mci_ResetWallHeadingEstimate(int32_t travelEdges, uint32_t leftReading,
+    uint32_t rightReading);
+uint32_t mci_EstimateWallHeading(int32_t travelEdges, uint32_t leftReading,
+    uint32_t rightReading, int32_t *p_heading);
+
+#endif /* ODOMETRY_MCI_H_ */
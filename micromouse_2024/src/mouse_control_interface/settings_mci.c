@@ -0,0 +1,202 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : settings_mci.c
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-04-13
+* Purpose         : mouse control interface layer
+*
+* This is the source file for persistent mouse settings under the mouse
+* control interface.
+*
+* The mouse control interface uses the mouse hardware interface to define high
+* level micromouse functionality.
+*-----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include "shared_functions/fixedpoint_sf.h"
+#include "mouse_hardware_interface/usart_mhi.h"
+#include "mouse_hardware_interface/storage_mhi.h"
+#include "mouse_hardware_interface/irsensors_mhi.h"
+#include "mouse_control_interface/walldetection_mci.h"
+#include "mouse_control_interface/movement_mci.h"
+#include "mouse_control_interface/settings_mci.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+/* default straight move wheel difference PD gains */
+#define MCI_SETTINGS_DEFAULT_HEADING_KP    SF_Q16_FROM_FLOAT(2.0f)
+#define MCI_SETTINGS_DEFAULT_HEADING_KD    SF_Q16_FROM_FLOAT(0.2f)
+
+/* default straight move side wall centering PD gains */
+#define MCI_SETTINGS_DEFAULT_SENSOR_KP \
+    (SF_Q16_FROM_FLOAT(0.1f) / (int32_t)MCI_IR_RAW_FROM_10BIT(1u))
+#define MCI_SETTINGS_DEFAULT_SENSOR_KD \
+    (SF_Q16_FROM_FLOAT(0.01f) / (int32_t)MCI_IR_RAW_FROM_10BIT(1u))
+
+/* default turn per wheel position PD gains */
+#define MCI_SETTINGS_DEFAULT_WHEEL_KP      SF_Q16_FROM_FLOAT(1.0f)
+#define MCI_SETTINGS_DEFAULT_WHEEL_KD      SF_Q16_FROM_FLOAT(0.5f)
+
+/*----------------------------------------------------------------------------*/
+/*                               Debug Switches                               */
+/*----------------------------------------------------------------------------*/
+/* 1 = Enable Debug Trace Output */
+#define DEBUG_MCI_SETTINGS_ENABLE    (1)
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+static mci_settings_t settings;
+
+/*----------------------------------------------------------------------------*/
+/*                    Private (Static) Function Prototype                     */
+/*----------------------------------------------------------------------------*/
+static uint32_t mci_CalculateSettingsChecksum(const mci_settings_t *p_settings);
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+/**
+* Load settings from storage, falling back to defaults if none are valid
+*
+* \param None
+* \retval None
+*/
+void mci_LoadSettings(void)
+{
+    mhi_ReadStorage(&settings, sizeof(settings));
+    
+    if ((settings.magic != MCI_SETTINGS_MAGIC) || 
+        (settings.version != MCI_SETTINGS_VERSION) || 
+        (settings.checksum != mci_CalculateSettingsChecksum(&settings)))
+    {
+        mci_RestoreDefaultSettings();
+        
+#if defined(DEBUG_MCI_SETTINGS_ENABLE) && (DEBUG_MCI_SETTINGS_ENABLE == 1)
+        mhi_PrintString("No stored settings, using defaults\r\n");
+#endif /* DEBUG_MCI_SETTINGS_ENABLE */
+    }
+}
+
+/**
+* Save current settings to storage
+*
+* Blocks for a flash page write- only call while the mouse is stopped.
+*
+* \param None
+* \retval None
+*/
+void mci_SaveSettings(void)
+{
+    settings.magic = MCI_SETTINGS_MAGIC;
+    settings.version = MCI_SETTINGS_VERSION;
+    settings.checksum = mci_CalculateSettingsChecksum(&settings);
+    
+    mhi_WriteStorage(&settings, sizeof(settings));
+}
+
+/**
+* Replace current settings w/ defaults (storage is left alone)
+*
+* \param None
+* \retval None
+*/
+void mci_RestoreDefaultSettings(void)
+{
+    uint32_t i = 0u;
+    
+    settings.magic = MCI_SETTINGS_MAGIC;
+    settings.version = MCI_SETTINGS_VERSION;
+    
+    settings.headingGains.kp = MCI_SETTINGS_DEFAULT_HEADING_KP;
+    settings.headingGains.ki = 0;
+    settings.headingGains.kd = MCI_SETTINGS_DEFAULT_HEADING_KD;
+    
+    settings.sensorGains.kp = MCI_SETTINGS_DEFAULT_SENSOR_KP;
+    settings.sensorGains.ki = 0;
+    settings.sensorGains.kd = MCI_SETTINGS_DEFAULT_SENSOR_KD;
+    
+    settings.wheelGains.kp = MCI_SETTINGS_DEFAULT_WHEEL_KP;
+    settings.wheelGains.ki = 0;
+    settings.wheelGains.kd = MCI_SETTINGS_DEFAULT_WHEEL_KD;
+    
+    /* until the wheel motors are characterized speed is duty cycle, so the */
+    /* speed constants drive as they always have. Slower speeds are raised */
+    /* to the minimum duty cycle that moves the mouse */
+    for (i = 0u; i < MCI_WHEEL_TABLE_POINTS; i++)
+    {
+        settings.leftWheelTable.duty[i] = 
+            (uint16_t)(i << MCI_WHEEL_TABLE_STEP_SHIFT);
+        if (settings.leftWheelTable.duty[i] < MCI_MINIMUM_SPEED)
+        {
+            settings.leftWheelTable.duty[i] = MCI_MINIMUM_SPEED;
+        }
+        settings.rightWheelTable.duty[i] = settings.leftWheelTable.duty[i];
+    }
+    
+    /* tuned for 180mm test maze walls until calibrated on the mouse */
+    settings.irCalibration.frontThresholdRaw = 
+        MCI_FRONT_SENSOR_READING_THRESHOLD_RAW_180MM_WALLS_HARD_CODED;
+    settings.irCalibration.leftThresholdRaw = 
+        MCI_LEFT_SENSOR_READING_THRESHOLD_RAW_180MM_WALLS_HARD_CODED;
+    settings.irCalibration.rightThresholdRaw = 
+        MCI_RIGHT_SENSOR_READING_THRESHOLD_RAW_180MM_WALLS_HARD_CODED;
+    settings.irCalibration.frontCenteredRaw = 
+        MCI_FRONT_WALL_CENTERED_RAW_HARD_CODED;
+    settings.irCalibration.leftCenteredRaw = 
+        MCI_SIDE_WALL_CENTERED_RAW_HARD_CODED;
+    settings.irCalibration.rightCenteredRaw = 
+        MCI_SIDE_WALL_CENTERED_RAW_HARD_CODED;
+    
+    settings.checksum = mci_CalculateSettingsChecksum(&settings);
+}
+
+/**
+* Get current settings
+*
+* Changes made through the pointer take effect on the next move and are
+* kept across resets once mci_SaveSettings() is called.
+*
+* \param None
+* \retval pointer to current settings
+*/
+mci_settings_t *mci_GetSettings(void)
+{
+    return &settings;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                           Local Shared Functions                           */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                         Private (Static) Functions                         */
+/*----------------------------------------------------------------------------*/
+/**
+* Calculate checksum over every settings byte before the checksum field
+*
+* \param[in] p_settings Settings to check
+* \retval Fletcher-32 style checksum
+*/
+static uint32_t mci_CalculateSettingsChecksum(const mci_settings_t *p_settings)
+{
+    const uint8_t *p_byte = (const uint8_t *)p_settings;
+    uint32_t size = (uint32_t)((const uint8_t *)&p_settings->checksum - p_byte);
+    uint32_t sum1 = 0xFFFFu;
+    uint32_t sum2 = 0xFFFFu;
+    uint32_t i = 0u;
+    
+    for (i = 0u; i < size; i++)
+    {
+        sum1 = (sum1 + p_byte[i]) % 0xFFFFu;
+        sum2 = (sum2 + sum1) % 0xFFFFu;
+    }
+    
+    return (sum2 << 16) | sum1;
+}
@@ -0,0 +1,84 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : settings_mci.h
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-04-13
+* Purpose         : mouse control interface layer
+*
+* This is the header file for persistent mouse settings under the mouse
+* control interface.
+*
+* Settings are kept in RAM and loaded from nonvolatile storage at startup.
+* Stored settings w/ a wrong magic number, version or checksum are ignored
+* and defaults are used instead. Bump the version whenever mci_settings_t
+* changes.
+*
+* The mouse control interface uses the mouse hardware interface to define high
+* level micromouse functionality.
+*-----------------------------------------------------------------------------*/
+
+#ifndef SETTINGS_MCI_H_
+#define SETTINGS_MCI_H_
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+#define MCI_SETTINGS_MAGIC      (0x4B524942u)   /* "KRIB" */
+#define MCI_SETTINGS_VERSION    (6u)
+
+/* controller gains in Q16.16 */
+typedef struct
+{
+    sf_q16_t kp;
+    sf_q16_t ki;
+    sf_q16_t kd;
+} mci_pid_gains_t;
+
+/* wheel speed to duty cycle table- speed 0 to 256 in steps of 16 */
+#define MCI_WHEEL_TABLE_POINTS      (17u)
+#define MCI_WHEEL_TABLE_STEP_SHIFT  (4u)
+
+/* first point is the deadband duty cycle, used for any nonzero speed */
+typedef struct
+{
+    uint16_t duty[MCI_WHEEL_TABLE_POINTS];
+} mci_wheel_table_t;
+
+/* IR sensor raw readings, front is the IR1 and IR4 average */
+typedef struct
+{
+    uint16_t frontThresholdRaw;     /* front wall found at or above */
+    uint16_t leftThresholdRaw;      /* left wall found at or above */
+    uint16_t rightThresholdRaw;     /* right wall found at or above */
+    uint16_t frontCenteredRaw;      /* front wall w/ mouse centered */
+    uint16_t leftCenteredRaw;       /* left wall w/ mouse centered */
+    uint16_t rightCenteredRaw;      /* right wall w/ mouse centered */
+} mci_ir_calibration_t;
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    mci_pid_gains_t headingGains;   /* straight move wheel difference loop */
+    mci_pid_gains_t sensorGains;    /* straight move side wall centering */
+    mci_pid_gains_t wheelGains;     /* per wheel position loop for turns */
+    mci_wheel_table_t leftWheelTable;   /* left wheel (motor 1) */
+    mci_wheel_table_t rightWheelTable;  /* right wheel (motor 2) */
+    mci_ir_calibration_t irCalibration; /* wall thresholds and setpoints */
+    uint32_t checksum;              /* keep last */
+} mci_settings_t;
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+void mci_LoadSettings(void);
+void mci_SaveSettings(void);
+void mci_RestoreDefaultSettings(void);
+mci_settings_t *mci_GetSettings(void);
+
+#endif /* SETTINGS_MCI_H_ */
@@ -0,0 +1,176 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : stall_mci.c
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-04-13
+* Purpose         : mouse control interface layer
+*
+* This is the source file for wheel stall detection under the mouse control
+* interface.
+*
+* A stalled mouse is pinned against a wall- the driver's current limit
+* detect pin stays asserted and/or a driven wheel's encoder stops counting.
+*
+* The mouse control interface uses the mouse hardware interface to define high
+* level micromouse functionality.
+*-----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdlib.h>
+#include "mouse_hardware_interface/usart_mhi.h"
+#include "mouse_hardware_interface/motors_mhi.h"
+#include "mouse_hardware_interface/interrupts_mhi.h"
+#include "mouse_control_interface/stall_mci.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+/* control ticks CLD must stay asserted- ignores start up current spikes */
+#define MCI_STALL_CURRENT_LIMIT_TICKS    (6u)
+
+/* control ticks a wheel driven at least this hard may go w/o an edge */
+#define MCI_STALL_DRIVEN_SPEED           (100)
+#define MCI_STALL_NO_EDGE_TICKS          (25u)
+
+/*----------------------------------------------------------------------------*/
+/*                               Debug Switches                               */
+/*----------------------------------------------------------------------------*/
+/* 1 = Enable Debug Trace Output */
+#define DEBUG_MCI_STALL_ENABLE    (1)
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+static uint32_t currentLimitTicks = 0u;
+static uint32_t leftNoEdgeTicks = 0u;
+static uint32_t rightNoEdgeTicks = 0u;
+static int32_t lastLeftEdgeCount = 0;
+static int32_t lastRightEdgeCount = 0;
+static uint32_t stallEventCount = 0u;
+
+/*----------------------------------------------------------------------------*/
+/*                    Private (Static) Function Prototype                     */
+/*----------------------------------------------------------------------------*/
+static uint32_t mci_CheckWheelProgress(int32_t speed, int32_t edgeCount,
+    int32_t *p_lastEdgeCount, uint32_t *p_noEdgeTicks);
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+/**
+* Reset stall detection at the start of a movement
+*
+* Call after the encoder edge counts are cleared.
+*
+* \param None
+* \retval None
+*/
+void mci_ResetStallMonitor(void)
+{
+    currentLimitTicks = 0u;
+    leftNoEdgeTicks = 0u;
+    rightNoEdgeTicks = 0u;
+    lastLeftEdgeCount = (int32_t)mhi_GetEncoder1EdgeCount();
+    lastRightEdgeCount = (int32_t)mhi_GetEncoder2EdgeCount();
+}
+
+/**
+* Check for a wheel stall once per control tick
+*
+* \param[in] leftSpeed Signed speed the left wheel was last driven at
+* \param[in] rightSpeed Signed speed the right wheel was last driven at
+* \retval MCI_STALL_NONE or a combination of MCI_STALL_* flags
+*/
+uint32_t mci_CheckStall(int32_t leftSpeed, int32_t rightSpeed)
+{
+    uint32_t stall = MCI_STALL_NONE;
+    
+    /* driver current limit must hold to count as a stall */
+    if (mhi_CheckWheelMotorCurrentLimit() == MHI_WHEEL_MOTOR_CURRENT_LIMITED)
+    {
+        currentLimitTicks++;
+        if (currentLimitTicks >= MCI_STALL_CURRENT_LIMIT_TICKS)
+        {
+            stall |= MCI_STALL_CURRENT_LIMIT;
+        }
+    }
+    else
+    {
+        currentLimitTicks = 0u;
+    }
+    
+    /* a driven wheel must keep counting edges */
+    if (!mci_CheckWheelProgress(leftSpeed, 
+        (int32_t)mhi_GetEncoder1EdgeCount(), &lastLeftEdgeCount, 
+        &leftNoEdgeTicks))
+    {
+        stall |= MCI_STALL_LEFT_WHEEL;
+    }
+    if (!mci_CheckWheelProgress(rightSpeed, 
+        (int32_t)mhi_GetEncoder2EdgeCount(), &lastRightEdgeCount, 
+        &rightNoEdgeTicks))
+    {
+        stall |= MCI_STALL_RIGHT_WHEEL;
+    }
+    
+    if (stall != MCI_STALL_NONE)
+    {
+        stallEventCount++;
+        
+#if defined(DEBUG_MCI_STALL_ENABLE) && (DEBUG_MCI_STALL_ENABLE == 1)
+        mhi_PrintString("Wheel stall: ");
+        mhi_PrintInt(stall);
+        mhi_PrintString("\r\n");
+#endif /* DEBUG_MCI_STALL_ENABLE */
+    }
+    
+    return stall;
+}
+
+/**
+* Access function for the number of stalls detected since power up
+*
+* \param None
+* \retval stallEventCount Stalls detected
+*/
+uint32_t mci_GetStallEventCount(void)
+{
+    return stallEventCount;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                           Local Shared Functions                           */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                         Private (Static) Functions                         */
+/*----------------------------------------------------------------------------*/
+/**
+* Track encoder progress of one wheel against its drive
+*
+* \param[in] speed Signed speed the wheel was last driven at
+* \param[in] edgeCount Wheel encoder edge count
+* \param[in,out] p_lastEdgeCount Edge count at the last progress
+* \param[in,out] p_noEdgeTicks Driven control ticks since the last progress
+* \retval 1 Wheel is turning or not driven hard enough to judge
+* \retval 0 Wheel is driven but has stopped counting edges
+*/
+static uint32_t mci_CheckWheelProgress(int32_t speed, int32_t edgeCount,
+    int32_t *p_lastEdgeCount, uint32_t *p_noEdgeTicks)
+{
+    if ((edgeCount != *p_lastEdgeCount) || 
+        (abs(speed) < MCI_STALL_DRIVEN_SPEED))
+    {
+        *p_lastEdgeCount = edgeCount;
+        *p_noEdgeTicks = 0u;
+        return 1u;
+    }
+    
+    (*p_noEdgeTicks)++;
+    
+    return (*p_noEdgeTicks < MCI_STALL_NO_EDGE_TICKS);
+}
@@ -0,0 +1,39 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : stall_mci.h
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-04-13
+* Purpose         : mouse control interface layer
+*
+* This is the header file for wheel stall detection under the mouse control
+* interface.
+*
+* The mouse control interface uses the mouse hardware interface to define high
+* level micromouse functionality.
+*-----------------------------------------------------------------------------*/
+
+#ifndef STALL_MCI_H_
+#define STALL_MCI_H_
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+/* stall flags from mci_CheckStall() */
+#define MCI_STALL_NONE             (0x0u)
+#define MCI_STALL_CURRENT_LIMIT    (0x1u)    /* driver held current limit */
+#define MCI_STALL_LEFT_WHEEL       (0x2u)    /* driven left wheel not turning */
+#define MCI_STALL_RIGHT_WHEEL      (0x4u)    /* driven right wheel not turning */
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+void mci_ResetStallMonitor(void);
+uint32_t mci_CheckStall(int32_t leftSpeed, int32_t rightSpeed);
+uint32_t mci_GetStallEventCount(void);
+
+#endif /* STALL_MCI_H_ */
@@ -39,6 +39,7 @@
 /*                              Global Variables                              */
 /*----------------------------------------------------------------------------*/
 int32_t startTime = 0;
+static uint32_t lastControlTick = 0u;
 
 /*----------------------------------------------------------------------------*/
 /*                    Private (Static) Function Prototype                     */
@@ -79,7 +80,7 @@ uint32_t mci_GetTimeMs(void)
 {
     int32_t currentTime = mhi_GetTimerCount();
     uint32_t timeElapsed = (uint32_t)(currentTime - startTime);
-    timeElapsed *= 8;
+    timeElapsed *= MCI_CONTROL_TICK_MS;
     
     return timeElapsed;
 }
@@ -106,6 +107,61 @@ void mci_DelayUs(const uint32_t delayTime)
     mhi_DelayUs(delayTime);
 }
 
+/**
+* Wait for the start of the next control tick
+*
+* Paces control loops so every loop runs at the same period regardless of
+* how long one iteration takes. Returns immediately if a tick has already
+* passed since the last call.
+*
+* \param None
+* \retval None
+*/
+void mci_WaitForControlTick(void)
+{
+    while (!mci_CheckControlTick())
+    {
+        /* wait for timer counter interrupt */
+    }
+}
+
+/**
+* Check for the start of a new control tick w/o waiting
+*
+* Each tick is only reported once, shared w/ mci_WaitForControlTick().
+*
+* \param None
+* \retval 1 A tick has passed since the last check or wait
+* \retval 0 Still in the same tick
+*/
+uint32_t mci_CheckControlTick(void)
+{
+    uint32_t currentTick = mhi_GetTimerCount();
+    
+    if (currentTick == lastControlTick)
+    {
+        return 0u;
+    }
+    
+    lastControlTick = currentTick;
+    return 1u;
+}
+
+/**
+* Check for the start of a new control tick w/o using it up
+*
+* For background work that has to yield to the control loop- the tick is
+* still reported by the next mci_CheckControlTick() or wait.
+*
+* \param None
+* \retval 1 A tick is waiting to be handled
+* \retval 0 Still in the same tick
+*/
+uint32_t mci_PeekControlTick(void)
+{
+    return (mhi_GetTimerCount() != lastControlTick) ? 1u : 0u;
+}
+
 /*----------------------------------------------------------------------------*/
 /*                           Local Shared Functions                           */
 /*----------------------------------------------------------------------------*/
@@ -18,7 +18,8 @@
 /*----------------------------------------------------------------------------*/
 /*                                Definitions                                 */
 /*----------------------------------------------------------------------------*/
-/* None */
+/* control loop period- one timer counter count */
+#define MCI_CONTROL_TICK_MS    (8u)
 
 /*----------------------------------------------------------------------------*/
 /*                              Global Variables                              */
@@ -33,5 +34,8 @@ void mci_ResetTimer(void);
 uint32_t mci_GetTimeMs(void);
 void mci_DelayMs(const uint32_t delayTime);
 void mci_DelayUs(const uint32_t delayTime);
+void mci_WaitForControlTick(void);
+uint32_t mci_CheckControlTick(void);
+uint32_t mci_PeekControlTick(void);
 
 #endif /* TIME_MCI_H_ */
\ No newline at end of file
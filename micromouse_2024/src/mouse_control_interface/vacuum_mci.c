@@ -0,0 +1,117 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : vacuum_mci.c
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-04-13
+* Purpose         : mouse control interface layer
+*
+* This is the source file for the vacuum fan under the mouse control
+* interface.
+*
+* The mouse control interface uses the mouse hardware interface to define high
+* level micromouse functionality.
+*-----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include "mouse_hardware_interface/motors_mhi.h"
+#include "mouse_control_interface/time_mci.h"
+#include "mouse_control_interface/vacuum_mci.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+/* fan duty cycle during a run (0~255) */
+#define MCI_VACUUM_RUN_DUTY          (200u)
+/* duty cycle increase per control tick- soft start limits the current surge */
+#define MCI_VACUUM_SPIN_UP_STEP      (8u)
+/* time at run duty for suction to build before the mouse moves */
+#define MCI_VACUUM_SETTLE_MS         (200u)
+
+/*----------------------------------------------------------------------------*/
+/*                               Debug Switches                               */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+static mci_downforce_t downforce = MCI_DOWNFORCE_OFF;
+
+/*----------------------------------------------------------------------------*/
+/*                    Private (Static) Function Prototype                     */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+/**
+* Spin the vacuum fan up to run speed
+*
+* Blocks while the fan ramps up and suction builds. Motion limits only
+* switch to their downforce values once this returns.
+*
+* \param None
+* \retval None
+*/
+void mci_StartDownforce(void)
+{
+    uint16_t duty = 0u;
+    
+    if (downforce == MCI_DOWNFORCE_ON)
+        return;
+    
+    while (duty < MCI_VACUUM_RUN_DUTY)
+    {
+        duty += MCI_VACUUM_SPIN_UP_STEP;
+        if (duty > MCI_VACUUM_RUN_DUTY)
+        {
+            duty = MCI_VACUUM_RUN_DUTY;
+        }
+        
+        mci_WaitForControlTick();
+        mhi_StartVacuumMotor(duty);
+    }
+    mci_DelayMs(MCI_VACUUM_SETTLE_MS);
+    
+    downforce = MCI_DOWNFORCE_ON;
+}
+
+/**
+* Stop the vacuum fan
+*
+* Motion limits drop back to their no suction values right away.
+*
+* \param None
+* \retval None
+*/
+void mci_StopDownforce(void)
+{
+    downforce = MCI_DOWNFORCE_OFF;
+    mhi_StopVacuumMotor();
+}
+
+/**
+* Access function for downforce state
+*
+* \param None
+* \retval MCI_DOWNFORCE_ON Fan is at run speed
+* \retval MCI_DOWNFORCE_OFF Fan is off or still spinning up
+*/
+mci_downforce_t mci_GetDownforce(void)
+{
+    return downforce;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                           Local Shared Functions                           */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                         Private (Static) Functions                         */
+/*----------------------------------------------------------------------------*/
+/* None */
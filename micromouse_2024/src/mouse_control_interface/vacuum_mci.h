@@ -0,0 +1,42 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : vacuum_mci.h
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-04-13
+* Purpose         : mouse control interface layer
+*
+* This is the header file for the vacuum fan under the mouse control
+* interface.
+*
+* Fan suction presses the mouse onto the maze floor, so the motion profiles
+* can use higher acceleration and cornering limits while it is on.
+*
+* The mouse control interface uses the mouse hardware interface to define high
+* level micromouse functionality.
+*-----------------------------------------------------------------------------*/
+
+#ifndef VACUUM_MCI_H_
+#define VACUUM_MCI_H_
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+typedef enum
+{
+    MCI_DOWNFORCE_OFF = 0u,
+    MCI_DOWNFORCE_ON            /* fan is at run speed */
+} mci_downforce_t;
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+void mci_StartDownforce(void);
+void mci_StopDownforce(void);
+mci_downforce_t mci_GetDownforce(void);
+
+#endif /* VACUUM_MCI_H_ */
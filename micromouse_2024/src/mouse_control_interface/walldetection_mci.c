@@ -18,16 +18,28 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <math.h>
+#include "mrepeat.h"
 #include "micromouse_dimensions.h"
+#include "shared_functions/fixedpoint_sf.h"
 #include "mouse_hardware_interface/leds_mhi.h"
 #include "mouse_hardware_interface/usart_mhi.h"
 #include "mouse_hardware_interface/irsensors_mhi.h"
 #include "mouse_control_interface/walldetection_mci.h"
+#include "mouse_control_interface/settings_mci.h"
+#include "mouse_control_interface/time_mci.h"
 
 /*----------------------------------------------------------------------------*/
 /*                                Definitions                                 */
 /*----------------------------------------------------------------------------*/
-/* None */
+/* one mm to raw table entry, mm is the MREPEAT index */
+#define MCI_IR_TABLE_ENTRY(mm, scale) \
+    MCI_READING_MM_TO_RAW_SCALED(scale, mm),
+
+/* front wall votes per check, read at a standstill- enough for the votes */
+/* to reach MCI_WALL_EVIDENCE_DECISION. Spaced past the IR filter delay so */
+/* each vote comes from fresh scans */
+#define MCI_FRONT_WALL_EVIDENCE_SAMPLES    (4u)
+#define MCI_FRONT_WALL_SAMPLE_SPACING_US   (1000u)
 
 /*----------------------------------------------------------------------------*/
 /*                               Debug Switches                               */
@@ -38,9 +50,9 @@
 /*----------------------------------------------------------------------------*/
 /*                              Global Variables                              */
 /*----------------------------------------------------------------------------*/
-static mci_wall_presence_t frontWallPresence = MCI_WALL_NOT_FOUND;
-static mci_wall_presence_t leftWallPresence = MCI_CANNOT_READ_WALL;
-static mci_wall_presence_t rightWallPresence = MCI_CANNOT_READ_WALL;
+static mci_wall_evidence_t frontWall = {MCI_WALL_NOT_FOUND, 0, 0u, 0u};
+static mci_wall_evidence_t leftWall = {MCI_CANNOT_READ_WALL, 0, 0u, 0u};
+static mci_wall_evidence_t rightWall = {MCI_CANNOT_READ_WALL, 0, 0u, 0u};
 
 static mci_wall_update_availability_t frontWallUpdateAvailable 
     = MCI_WALL_UPDATE_AVAILABLE;
@@ -49,10 +61,38 @@ static mci_wall_update_availability_t leftWallUpdateAvailable
 static mci_wall_update_availability_t rightWallUpdateAvailable 
     = MCI_WALL_UPDATE_NOT_AVAILABLE;
 
+/* confident readings in a row against known walls, per sensor */
+static uint32_t mapDisagreements[MCI_IR_SENSOR_COUNT];
+
+/* last debounced side wall state for edge detection */
+static mci_wall_presence_t leftEdgeState = MCI_CANNOT_READ_WALL;
+static mci_wall_presence_t rightEdgeState = MCI_CANNOT_READ_WALL;
+
+/* raw reading at each mm from the sensor, built by the preprocessor */
+static const uint16_t irMmToRawTables[MCI_IR_SENSOR_COUNT]
+    [MCI_IR_TABLE_LENGTH] =
+{
+    {MREPEAT(MCI_IR_TABLE_LENGTH, MCI_IR_TABLE_ENTRY, 
+        MCI_IR1_READING_RAW_AT_0MM)},
+    {MREPEAT(MCI_IR_TABLE_LENGTH, MCI_IR_TABLE_ENTRY, 
+        MCI_IR2_READING_RAW_AT_0MM)},
+    {MREPEAT(MCI_IR_TABLE_LENGTH, MCI_IR_TABLE_ENTRY, 
+        MCI_IR3_READING_RAW_AT_0MM)},
+    {MREPEAT(MCI_IR_TABLE_LENGTH, MCI_IR_TABLE_ENTRY, 
+        MCI_IR4_READING_RAW_AT_0MM)}
+};
+
 /*----------------------------------------------------------------------------*/
 /*                    Private (Static) Function Prototype                     */
 /*----------------------------------------------------------------------------*/
-/* None */
+static mci_wall_edge_t mci_DetectWallEdge(mci_wall_presence_t *p_state,
+    uint32_t reading, uint32_t threshold);
+static void mci_ResetWallEvidence(mci_wall_evidence_t *p_wall);
+static void mci_AddWallEvidence(mci_wall_evidence_t *p_wall, 
+    uint32_t reading, uint32_t threshold);
+static uint32_t mci_GetWallConfidence(const mci_wall_evidence_t *p_wall);
+static void mci_CheckWallAgainstMap(const mci_wall_evidence_t *p_wall,
+    mci_wall_presence_t expected, mci_ir_sensor_t sensor);
 
 /*----------------------------------------------------------------------------*/
 /*                       Public (Exportable) Functions                        */
@@ -67,26 +107,20 @@ static mci_wall_update_availability_t rightWallUpdateAvailable
 */
 void mci_PrintWallSensorReadings(void)
 {
-    uint32_t reading1 = 0u;
-    uint32_t reading2 = 0u;
-    uint32_t reading3 = 0u;
-    uint32_t reading4 = 0u;
+    uint32_t readings[MHI_IR_COUNT] = {0u};
     
-    reading1 = mhi_ReadIr1();
-    reading2 = mhi_ReadIr2();
-    reading3 = mhi_ReadIr3();
-    reading4 = mhi_ReadIr4();
+    mhi_ReadAllIr(readings);
     
-    mhi_PrintInt(reading1);
+    mhi_PrintInt(readings[MHI_IR1_INDEX]);
     mhi_PrintString(" ");
     
-    mhi_PrintInt(reading2);
+    mhi_PrintInt(readings[MHI_IR2_INDEX]);
     mhi_PrintString(" ");
     
-    mhi_PrintInt(reading3);
+    mhi_PrintInt(readings[MHI_IR3_INDEX]);
     mhi_PrintString(" ");
     
-    mhi_PrintInt(reading4);
+    mhi_PrintInt(readings[MHI_IR4_INDEX]);
     mhi_PrintString("\r\n");
 }
 
@@ -101,6 +135,7 @@ void mci_PrintWallSensorReadings(void)
 void mci_PrintWallPresence(void)
 {
     /* comment below block when using w/ movement functions */
+    mci_ResetSideWallEvidence();
     mci_SetFrontWallUpdateAvailable();
     mci_SetLeftWallUpdateAvailable();
     mci_SetRightWallUpdateAvailable();
@@ -160,6 +195,13 @@ void mci_PrintWallPresence(void)
     mhi_PrintString(" ");
     mhi_PrintInt((uint32_t)MCI_RIGHT_SENSOR_READING_THRESHOLD_RAW);
     mhi_PrintString("\r\n");
+    
+    mhi_PrintInt(mci_GetFrontWallConfidence());
+    mhi_PrintString(" ");
+    mhi_PrintInt(mci_GetLeftWallConfidence());
+    mhi_PrintString(" ");
+    mhi_PrintInt(mci_GetRightWallConfidence());
+    mhi_PrintString("\r\n");
 }
 
 /**
@@ -236,42 +278,72 @@ void mci_SetRightWallUpdateAvailable(void)
 */
 void mci_ClearLeftRightWallPresence(void)
 {
-    leftWallPresence = MCI_CANNOT_READ_WALL;
-    rightWallPresence = MCI_CANNOT_READ_WALL;
+    leftWall.presence = MCI_CANNOT_READ_WALL;
+    rightWall.presence = MCI_CANNOT_READ_WALL;
+}
+
+/**
+* Forget side wall evidence so the next readings decide a new square
+*
+* Call before the first side wall update of each square.
+*
+* \param None
+* \retval None
+*/
+void mci_ResetSideWallEvidence(void)
+{
+    mci_ResetWallEvidence(&leftWall);
+    mci_ResetWallEvidence(&rightWall);
 }
 
 /**
 * Update front wall presence variable
 *
+* Replaces the front evidence w/ MCI_FRONT_WALL_EVIDENCE_SAMPLES votes from
+* scans over a few ms. Only call while the mouse stands still.
+*
 * \param None
 * \retval None
 */
 void mci_UpdateFrontWallPresence(void)
 {
-    uint32_t reading1 = 0u;
-    uint32_t reading2 = 0u;
+    uint32_t readings[MCI_IR_SENSOR_COUNT] = {0u};
+    uint32_t failed = 0u;
+    uint32_t i = 0u;
     
-    /* read front IR sensors */
-    reading1 = mhi_ReadIr1();
-    reading2 = mhi_ReadIr4();
+    if (frontWallUpdateAvailable != MCI_WALL_UPDATE_AVAILABLE)
+    {
+        return;
+    }
     
-    /* update front wall presence variable if available */
-    if (frontWallUpdateAvailable == MCI_WALL_UPDATE_AVAILABLE)
+    /* front is read at a standstill- a fresh window of votes decides it */
+    mci_ResetWallEvidence(&frontWall);
+    for (i = 0u; i < MCI_FRONT_WALL_EVIDENCE_SAMPLES; i++)
     {
-        if (((reading1 + reading2) / 2) >= MCI_FRONT_SENSOR_READING_THRESHOLD_RAW)
+        if (i > 0u)
         {
-            frontWallPresence = MCI_WALL_FOUND;
+            mci_DelayUs(MCI_FRONT_WALL_SAMPLE_SPACING_US);
         }
-        else
+        
+        /* read front IR sensors, a failed one reads the same as the other */
+        failed = mci_ReadHealthyIr(readings);
+        if ((failed & MCI_IR_FAILED_FRONT_PAIR) == MCI_IR_FAILED_FRONT_PAIR)
         {
-            frontWallPresence = MCI_WALL_NOT_FOUND;
+            break;
         }
+        
+        mci_AddWallEvidence(&frontWall, 
+            (readings[MCI_IR_SENSOR_LEFT_FRONT] + 
+            readings[MCI_IR_SENSOR_RIGHT_FRONT]) / 2u, 
+            MCI_FRONT_SENSOR_READING_THRESHOLD_RAW);
     }
 }
 
 /**
 * Update left wall presence variable
 *
+* Adds the reading to the evidence gathered since the last reset.
+*
 * \param None
 * \retval None
 */
@@ -282,23 +354,20 @@ void mci_UpdateLeftWallPresence(void)
     /* read left IR sensor */
     reading = mhi_ReadIr2();
     
-    /* update front wall presence variable if available */
-    if (leftWallUpdateAvailable == MCI_WALL_UPDATE_AVAILABLE)
+    /* vote on left wall presence if available- a failed sensor can't vote */
+    if ((leftWallUpdateAvailable == MCI_WALL_UPDATE_AVAILABLE) &&
+        (mhi_GetIrHealth(MHI_IR2_INDEX) == MHI_IR_HEALTHY))
     {
-        if (reading >= MCI_LEFT_SENSOR_READING_THRESHOLD_RAW)
-        {
-            leftWallPresence = MCI_WALL_FOUND;
-        }
-        else
-        {
-            leftWallPresence = MCI_WALL_NOT_FOUND;
-        }
+        mci_AddWallEvidence(&leftWall, reading, 
+            MCI_LEFT_SENSOR_READING_THRESHOLD_RAW);
     }
 }
 
 /**
 * Update right wall presence variable
 *
+* Adds the reading to the evidence gathered since the last reset.
+*
 * \param None
 * \retval None
 */
@@ -309,17 +378,12 @@ void mci_UpdateRightWallPresence(void)
     /* read left IR sensor */
     reading = mhi_ReadIr3();
     
-    /* update front wall presence variable if available */
-    if (rightWallUpdateAvailable == MCI_WALL_UPDATE_AVAILABLE)
+    /* vote on right wall presence if available- a failed sensor can't vote */
+    if ((rightWallUpdateAvailable == MCI_WALL_UPDATE_AVAILABLE) &&
+        (mhi_GetIrHealth(MHI_IR3_INDEX) == MHI_IR_HEALTHY))
     {
-        if (reading >= MCI_RIGHT_SENSOR_READING_THRESHOLD_RAW)
-        {
-            rightWallPresence = MCI_WALL_FOUND;
-        }
-        else
-        {
-            rightWallPresence = MCI_WALL_NOT_FOUND;
-        }
+        mci_AddWallEvidence(&rightWall, reading, 
+            MCI_RIGHT_SENSOR_READING_THRESHOLD_RAW);
     }
 }
 
@@ -331,9 +395,9 @@ void mci_UpdateRightWallPresence(void)
 */
 void mci_UpdateWallPresenceRightTurn(void)
 {
-    leftWallPresence = frontWallPresence;
-    frontWallPresence = rightWallPresence;
-    rightWallPresence = MCI_CANNOT_READ_WALL;
+    leftWall = frontWall;
+    frontWall = rightWall;
+    mci_ResetWallEvidence(&rightWall);
 }
 
 /**
@@ -344,9 +408,9 @@ void mci_UpdateWallPresenceRightTurn(void)
 */
 void mci_UpdateWallPresenceLeftTurn(void)
 {
-    rightWallPresence = frontWallPresence;
-    frontWallPresence = leftWallPresence;
-    leftWallPresence = MCI_CANNOT_READ_WALL;
+    rightWall = frontWall;
+    frontWall = leftWall;
+    mci_ResetWallEvidence(&leftWall);
 }
 
 /**
@@ -360,7 +424,7 @@ void mci_UpdateWallPresenceLeftTurn(void)
 mci_wall_presence_t mci_CheckFrontWall(void)
 {
     mci_UpdateFrontWallPresence();    
-    return frontWallPresence;
+    return frontWall.presence;
 }
 
 /**
@@ -374,7 +438,7 @@ mci_wall_presence_t mci_CheckFrontWall(void)
 mci_wall_presence_t mci_CheckLeftWall(void)
 {
     mci_UpdateLeftWallPresence();
-    return leftWallPresence;
+    return leftWall.presence;
 }
 
 /**
@@ -388,7 +452,257 @@ mci_wall_presence_t mci_CheckLeftWall(void)
 mci_wall_presence_t mci_CheckRightWall(void)
 {
     mci_UpdateRightWallPresence();
-    return rightWallPresence;
+    return rightWall.presence;
+}
+
+/**
+* Get how sure the last front wall check was
+*
+* The front window is short, so a few readings just past the threshold
+* would still average out to a usable confidence. Only a decided front wall
+* gets any.
+*
+* \param None
+* \retval confidence, 0 (a guess) to MCI_WALL_CONFIDENCE_FULL
+*/
+uint32_t mci_GetFrontWallConfidence(void)
+{
+    if (!frontWall.decided)
+    {
+        return 0u;
+    }
+    
+    return mci_GetWallConfidence(&frontWall);
+}
+
+/**
+* Get how sure the left wall presence is
+*
+* \param None
+* \retval confidence, 0 (a guess) to MCI_WALL_CONFIDENCE_FULL
+*/
+uint32_t mci_GetLeftWallConfidence(void)
+{
+    return mci_GetWallConfidence(&leftWall);
+}
+
+/**
+* Get how sure the right wall presence is
+*
+* \param None
+* \retval confidence, 0 (a guess) to MCI_WALL_CONFIDENCE_FULL
+*/
+uint32_t mci_GetRightWallConfidence(void)
+{
+    return mci_GetWallConfidence(&rightWall);
+}
+
+/**
+* Compare the front wall presence w/ a wall the map already knows
+*
+* Both front sensors share the blame for a disagreement.
+*
+* \param[in] expected Front wall presence known from the map
+* \retval None
+*/
+void mci_ExpectFrontWall(mci_wall_presence_t expected)
+{
+    mci_CheckWallAgainstMap(&frontWall, expected, MCI_IR_SENSOR_LEFT_FRONT);
+    mci_CheckWallAgainstMap(&frontWall, expected, MCI_IR_SENSOR_RIGHT_FRONT);
+}
+
+/**
+* Compare the left wall presence w/ a wall the map already knows
+*
+* \param[in] expected Left wall presence known from the map
+* \retval None
+*/
+void mci_ExpectLeftWall(mci_wall_presence_t expected)
+{
+    mci_CheckWallAgainstMap(&leftWall, expected, MCI_IR_SENSOR_LEFT);
+}
+
+/**
+* Compare the right wall presence w/ a wall the map already knows
+*
+* \param[in] expected Right wall presence known from the map
+* \retval None
+*/
+void mci_ExpectRightWall(mci_wall_presence_t expected)
+{
+    mci_CheckWallAgainstMap(&rightWall, expected, MCI_IR_SENSOR_RIGHT);
+}
+
+/**
+* Get the IR sensors that are not to be trusted
+*
+* \param None
+* \retval mask of MCI_IR_FAILED() bits, 0 when all sensors are healthy
+*/
+uint32_t mci_GetFailedIrSensors(void)
+{
+    uint32_t failed = 0u;
+    uint32_t sensor = 0u;
+    
+    /* sensor order matches the IR index order */
+    for (sensor = 0u; sensor < MCI_IR_SENSOR_COUNT; sensor++)
+    {
+        if (mhi_GetIrHealth(sensor) != MHI_IR_HEALTHY)
+        {
+            failed |= MCI_IR_FAILED(sensor);
+        }
+    }
+    
+    return failed;
+}
+
+/**
+* Read all IR sensors w/ failed sensors replaced by what's left
+*
+* A failed front sensor reads the same as the other front sensor, so the
+* pair still gives distance but no angle. A failed side sensor reads 0, so
+* its wall is never seen and control falls back to the other side or the
+* encoders. Both front sensors failed read 0 too.
+*
+* \param[out] p_readings Sensor readings in mci_ir_sensor_t order
+* \retval mask of MCI_IR_FAILED() bits, 0 when all sensors are healthy
+*/
+uint32_t mci_ReadHealthyIr(uint32_t p_readings[MCI_IR_SENSOR_COUNT])
+{
+    uint32_t failed = 0u;
+    
+    mhi_ReadAllIr(p_readings);
+    failed = mci_GetFailedIrSensors();
+    
+    if (failed & MCI_IR_FAILED(MCI_IR_SENSOR_LEFT_FRONT))
+    {
+        p_readings[MCI_IR_SENSOR_LEFT_FRONT] = 
+            (failed & MCI_IR_FAILED(MCI_IR_SENSOR_RIGHT_FRONT)) ? 0u : 
+            p_readings[MCI_IR_SENSOR_RIGHT_FRONT];
+    }
+    if (failed & MCI_IR_FAILED(MCI_IR_SENSOR_RIGHT_FRONT))
+    {
+        p_readings[MCI_IR_SENSOR_RIGHT_FRONT] = 
+            p_readings[MCI_IR_SENSOR_LEFT_FRONT];
+    }
+    if (failed & MCI_IR_FAILED(MCI_IR_SENSOR_LEFT))
+    {
+        p_readings[MCI_IR_SENSOR_LEFT] = 0u;
+    }
+    if (failed & MCI_IR_FAILED(MCI_IR_SENSOR_RIGHT))
+    {
+        p_readings[MCI_IR_SENSOR_RIGHT] = 0u;
+    }
+    
+    return failed;
+}
+
+/**
+* Forget side wall edge state so the next readings only set a baseline
+*
+* Call at the start of each straight move.
+*
+* \param None
+* \retval None
+*/
+void mci_ResetWallEdgeDetection(void)
+{
+    leftEdgeState = MCI_CANNOT_READ_WALL;
+    rightEdgeState = MCI_CANNOT_READ_WALL;
+}
+
+/**
+* Check a left sensor reading for the start or end of a left wall
+*
+* \param[in] reading Left IR sensor reading
+* \retval MCI_WALL_EDGE_NONE No transition
+* \retval MCI_WALL_EDGE_WALL_TO_GAP Left wall ended
+* \retval MCI_WALL_EDGE_GAP_TO_WALL Left wall started
+*/
+mci_wall_edge_t mci_DetectLeftWallEdge(uint32_t reading)
+{
+    return mci_DetectWallEdge(&leftEdgeState, reading, 
+        MCI_LEFT_SENSOR_READING_THRESHOLD_RAW);
+}
+
+/**
+* Check a right sensor reading for the start or end of a right wall
+*
+* \param[in] reading Right IR sensor reading
+* \retval MCI_WALL_EDGE_NONE No transition
+* \retval MCI_WALL_EDGE_WALL_TO_GAP Right wall ended
+* \retval MCI_WALL_EDGE_GAP_TO_WALL Right wall started
+*/
+mci_wall_edge_t mci_DetectRightWallEdge(uint32_t reading)
+{
+    return mci_DetectWallEdge(&rightEdgeState, reading, 
+        MCI_RIGHT_SENSOR_READING_THRESHOLD_RAW);
+}
+
+/**
+* Convert a distance from a sensor to the reading it gives
+*
+* \param[in] sensor Sensor to convert for
+* \param[in] distanceMm Distance to the wall along the sensor beam
+* \retval raw reading, the farthest table reading past the table
+*/
+uint32_t mci_ConvertMmToReading(mci_ir_sensor_t sensor, uint32_t distanceMm)
+{
+    if (distanceMm > MCI_IR_TABLE_MM_MAX)
+    {
+        distanceMm = MCI_IR_TABLE_MM_MAX;
+    }
+    
+    return irMmToRawTables[sensor][distanceMm];
+}
+
+/**
+* Convert a sensor reading to the distance along the sensor beam
+*
+* Binary search of the mm to raw table- readings fall as distance grows, so
+* the answer is the nearest mm whose reading is not above this one.
+*
+* \param[in] sensor Sensor the reading came from
+* \param[in] reading Raw sensor reading
+* \retval distance in mm, MCI_IR_TABLE_MM_MAX for readings past the table
+*/
+uint32_t mci_ConvertReadingToMm(mci_ir_sensor_t sensor, uint32_t reading)
+{
+    const uint16_t *p_table = irMmToRawTables[sensor];
+    uint32_t low = 0u;
+    uint32_t high = MCI_IR_TABLE_MM_MAX;
+    uint32_t middle = 0u;
+    
+    while (low < high)
+    {
+        middle = (low + high) / 2u;
+        if (p_table[middle] > reading)
+        {
+            low = middle + 1u;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    
+    return low;
+}
+
+/**
+* Get the distance to the wall seen by a sensor
+*
+* \param[in] sensor Sensor to read
+* \retval distance in mm along the sensor beam
+*/
+uint32_t mci_GetWallDistanceMm(mci_ir_sensor_t sensor)
+{
+    uint32_t readings[MHI_IR_COUNT] = {0u};
+    
+    mhi_ReadAllIr(readings);
+    
+    /* sensor order matches the IR index order */
+    return mci_ConvertReadingToMm(sensor, readings[sensor]);
 }
 
 /*----------------------------------------------------------------------------*/
@@ -399,4 +713,176 @@ mci_wall_presence_t mci_CheckRightWall(void)
 /*----------------------------------------------------------------------------*/
 /*                         Private (Static) Functions                         */
 /*----------------------------------------------------------------------------*/
-/* None */
+/**
+* Track one side wall w/ hysteresis and report transitions
+*
+* \param[in,out] p_state Debounced wall state for this side
+* \param[in] reading Side IR sensor reading
+* \param[in] threshold Wall threshold for this side
+* \retval transition seen on this reading, if any
+*/
+static mci_wall_edge_t mci_DetectWallEdge(mci_wall_presence_t *p_state,
+    uint32_t reading, uint32_t threshold)
+{
+    mci_wall_edge_t edge = MCI_WALL_EDGE_NONE;
+    
+    if (*p_state == MCI_CANNOT_READ_WALL)
+    {
+        /* first reading of the move only sets the baseline */
+        *p_state = (reading >= threshold) ? MCI_WALL_FOUND : 
+            MCI_WALL_NOT_FOUND;
+    }
+    else if ((*p_state == MCI_WALL_FOUND) && 
+        (reading + MCI_WALL_EDGE_HYSTERESIS_RAW < threshold))
+    {
+        *p_state = MCI_WALL_NOT_FOUND;
+        edge = MCI_WALL_EDGE_WALL_TO_GAP;
+    }
+    else if ((*p_state == MCI_WALL_NOT_FOUND) && 
+        (reading > threshold + MCI_WALL_EDGE_HYSTERESIS_RAW))
+    {
+        *p_state = MCI_WALL_FOUND;
+        edge = MCI_WALL_EDGE_GAP_TO_WALL;
+    }
+    
+    return edge;
+}
+
+/**
+* Forget a wall's evidence and mark it unread
+*
+* \param[out] p_wall Wall to reset
+* \retval None
+*/
+static void mci_ResetWallEvidence(mci_wall_evidence_t *p_wall)
+{
+    p_wall->presence = MCI_CANNOT_READ_WALL;
+    p_wall->weight = 0;
+    p_wall->samples = 0u;
+    p_wall->decided = 0u;
+}
+
+/**
+* Add one reading's vote to a wall and update its presence
+*
+* Readings vote their distance from the threshold in hysteresis steps, so
+* readings near the threshold count for little and noise cancels out over
+* the window. Presence follows the sign of the total until it passes
+* MCI_WALL_EVIDENCE_DECISION, after which it only flips past the opposite
+* bound.
+*
+* \param[in,out] p_wall Wall to update
+* \param[in] reading IR sensor reading
+* \param[in] threshold Wall threshold for the sensor
+* \retval None
+*/
+static void mci_AddWallEvidence(mci_wall_evidence_t *p_wall, 
+    uint32_t reading, uint32_t threshold)
+{
+    int32_t vote = 0;
+    
+    vote = ((int32_t)reading - (int32_t)threshold) / 
+        (int32_t)MCI_WALL_EDGE_HYSTERESIS_RAW;
+    if (vote > MCI_WALL_EVIDENCE_VOTE_MAX)
+    {
+        vote = MCI_WALL_EVIDENCE_VOTE_MAX;
+    }
+    else if (vote < -MCI_WALL_EVIDENCE_VOTE_MAX)
+    {
+        vote = -MCI_WALL_EVIDENCE_VOTE_MAX;
+    }
+    
+    p_wall->weight += vote;
+    p_wall->samples++;
+    
+    if (p_wall->weight >= MCI_WALL_EVIDENCE_DECISION)
+    {
+        p_wall->presence = MCI_WALL_FOUND;
+        p_wall->decided = 1u;
+    }
+    else if (p_wall->weight <= -MCI_WALL_EVIDENCE_DECISION)
+    {
+        p_wall->presence = MCI_WALL_NOT_FOUND;
+        p_wall->decided = 1u;
+    }
+    else if (!p_wall->decided)
+    {
+        /* no decision yet- best guess, the threshold breaks a tie */
+        if ((p_wall->weight > 0) || 
+            ((p_wall->weight == 0) && (reading >= threshold)))
+        {
+            p_wall->presence = MCI_WALL_FOUND;
+        }
+        else
+        {
+            p_wall->presence = MCI_WALL_NOT_FOUND;
+        }
+    }
+}
+
+/**
+* Get how strongly a wall's votes agree w/ its presence
+*
+* \param[in] p_wall Wall to check
+* \retval confidence, 0 w/o votes to MCI_WALL_CONFIDENCE_FULL when every
+*         reading voted the maximum the same way
+*/
+static uint32_t mci_GetWallConfidence(const mci_wall_evidence_t *p_wall)
+{
+    int32_t agreement = 0;
+    
+    if (p_wall->samples == 0u)
+    {
+        return 0u;
+    }
+    
+    /* weight against the current presence counts as no confidence */
+    agreement = (p_wall->presence == MCI_WALL_FOUND) ? p_wall->weight : 
+        -p_wall->weight;
+    if (agreement <= 0)
+    {
+        return 0u;
+    }
+    
+    return ((uint32_t)agreement * MCI_WALL_CONFIDENCE_FULL) / 
+        (p_wall->samples * (uint32_t)MCI_WALL_EVIDENCE_VOTE_MAX);
+}
+
+/**
+* Count confident disagreements between a wall and the map
+*
+* Unread and unsure walls say nothing about the sensor. After enough
+* confident disagreements in a row the sensor is flagged as failed.
+*
+* \param[in] p_wall Wall presence from the sensors
+* \param[in] expected Wall presence known from the map
+* \param[in] sensor Sensor behind the wall presence
+* \retval None
+*/
+static void mci_CheckWallAgainstMap(const mci_wall_evidence_t *p_wall,
+    mci_wall_presence_t expected, mci_ir_sensor_t sensor)
+{
+    if ((p_wall->presence == MCI_CANNOT_READ_WALL) || (!p_wall->decided))
+    {
+        return;
+    }
+    
+    if (p_wall->presence == expected)
+    {
+        mapDisagreements[sensor] = 0u;
+        return;
+    }
+    
+    mapDisagreements[sensor]++;
+    if (mapDisagreements[sensor] >= MCI_WALL_MAP_DISAGREEMENT_MAX)
+    {
+        /* sensor order matches the IR index order */
+        mhi_SetIrMapFault(sensor);
+        
+#if defined(DEBUG_MCI_WALL_DETECTION_ENABLE) && (DEBUG_MCI_WALL_DETECTION_ENABLE == 1)
+        mhi_PrintString("IR sensor disagrees w/ map: ");
+        mhi_PrintInt(sensor);
+        mhi_PrintString("\r\n");
+#endif /* DEBUG_MCI_WALL_DETECTION_ENABLE */
+    }
+}
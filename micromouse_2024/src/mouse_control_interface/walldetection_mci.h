@@ -31,6 +31,33 @@ typedef enum
     MCI_WALL_UPDATE_AVAILABLE
 } mci_wall_update_availability_t;
 
+/* one wall's presence w/ the readings that voted on it */
+typedef struct
+{
+    mci_wall_presence_t presence;
+    int32_t weight;         /* sum of votes, positive for a wall */
+    uint32_t samples;       /* readings that voted */
+    uint32_t decided;       /* 1 once weight passed a decision bound */
+} mci_wall_evidence_t;
+
+/* side sensor wall edge seen while moving straight */
+typedef enum
+{
+    MCI_WALL_EDGE_NONE = 0u,
+    MCI_WALL_EDGE_WALL_TO_GAP,      /* wall ends at a post */
+    MCI_WALL_EDGE_GAP_TO_WALL       /* wall starts at a post */
+} mci_wall_edge_t;
+
+/* IR sensors by position, same order as IR1 - IR4 */
+typedef enum
+{
+    MCI_IR_SENSOR_LEFT_FRONT = 0u,      /* IR1 */
+    MCI_IR_SENSOR_LEFT,                 /* IR2 */
+    MCI_IR_SENSOR_RIGHT,                /* IR3 */
+    MCI_IR_SENSOR_RIGHT_FRONT,          /* IR4 */
+    MCI_IR_SENSOR_COUNT
+} mci_ir_sensor_t;
+
 #define MCI_COS45DEG    (0.707f)    /* cosine of 45 degrees to reduce math */
 
 /* front sensor reading threshold in millimeters */
@@ -48,39 +75,125 @@ typedef enum
     MCI_MOUSE_DIAGONAL_SENSOR_OFFSET_MM) / MCI_COS45DEG) - \
     MCI_RIGHT_SENSOR_READING_TOLERANCE_TEST_MAZE)
 
-/* sensor threshold mm to raw converter, values found experimentally */
-#define MCI_READING_MM_TO_RAW(x) (896 * pow(0.98, x))
+/* raw values below were found w/ 10 bit readings- scaled to the reading */
+/* width so thresholds follow the ADC resolution (needs irsensors_mhi.h) */
+#define MCI_IR_RAW_10BIT_SHIFT          (MHI_IR_READING_BITS - 10u)
+#define MCI_IR_RAW_FROM_10BIT(x)        ((x) << MCI_IR_RAW_10BIT_SHIFT)
+
+/* sensor model raw = scale * 0.98^mm, values found experimentally */
+#define MCI_READING_RAW_AT_0MM \
+    (896.0 * (double)(1u << MCI_IR_RAW_10BIT_SHIFT))
+#define MCI_IR1_READING_RAW_AT_0MM      MCI_READING_RAW_AT_0MM
+#define MCI_IR2_READING_RAW_AT_0MM      MCI_READING_RAW_AT_0MM
+#define MCI_IR3_READING_RAW_AT_0MM      MCI_READING_RAW_AT_0MM
+#define MCI_IR4_READING_RAW_AT_0MM      MCI_READING_RAW_AT_0MM
+
+/* 0.98^x one binary power at a time- folds to a constant for constant x */
+#define MCI_READING_DECAY(x) \
+    ((((uint32_t)(x) & 0x001u) ? 0.98000000 : 1.0) * \
+    (((uint32_t)(x) & 0x002u) ? 0.96040000 : 1.0) * \
+    (((uint32_t)(x) & 0x004u) ? 0.92236816 : 1.0) * \
+    (((uint32_t)(x) & 0x008u) ? 0.85076302 : 1.0) * \
+    (((uint32_t)(x) & 0x010u) ? 0.72379772 : 1.0) * \
+    (((uint32_t)(x) & 0x020u) ? 0.52388314 : 1.0) * \
+    (((uint32_t)(x) & 0x040u) ? 0.27445354 : 1.0) * \
+    (((uint32_t)(x) & 0x080u) ? 0.07532475 : 1.0) * \
+    (((uint32_t)(x) & 0x100u) ? 0.00567382 : 1.0))
+
+/* sensor threshold mm to raw converter, x in [0, 511] */
+#define MCI_READING_MM_TO_RAW_SCALED(scale, x) \
+    ((uint32_t)(((scale) * MCI_READING_DECAY(x)) + 0.5))
+#define MCI_READING_MM_TO_RAW(x) \
+    MCI_READING_MM_TO_RAW_SCALED(MCI_READING_RAW_AT_0MM, x)
+
+/* mm to raw table length- no parentheses, MREPEAT pastes it */
+#define MCI_IR_TABLE_LENGTH     256
+#define MCI_IR_TABLE_MM_MAX     (MCI_IR_TABLE_LENGTH - 1)
 
 /* sensor threshold hard coded raw values- prepared since math is extremely slow */
 /* values found by running mci_PrintWallPresence() w/ thresholds printed after */
 /* changing wall length MCI_MAZE_WALL_LENGTH_MM */
-#define MCI_FRONT_SENSOR_READING_THRESHOLD_RAW_165MM_WALLS_HARD_CODED    (174)
-#define MCI_LEFT_SENSOR_READING_THRESHOLD_RAW_165MM_WALLS_HARD_CODED     (63)
-#define MCI_RIGHT_SENSOR_READING_THRESHOLD_RAW_165MM_WALLS_HARD_CODED    (63)
-
-#define MCI_FRONT_SENSOR_READING_THRESHOLD_RAW_180MM_WALLS_HARD_CODED    (128)
-#define MCI_LEFT_SENSOR_READING_THRESHOLD_RAW_180MM_WALLS_HARD_CODED     (101)
-#define MCI_RIGHT_SENSOR_READING_THRESHOLD_RAW_180MM_WALLS_HARD_CODED    (101)
+#define MCI_FRONT_SENSOR_READING_THRESHOLD_RAW_165MM_WALLS_HARD_CODED \
+    MCI_IR_RAW_FROM_10BIT(174u)
+#define MCI_LEFT_SENSOR_READING_THRESHOLD_RAW_165MM_WALLS_HARD_CODED \
+    MCI_IR_RAW_FROM_10BIT(63u)
+#define MCI_RIGHT_SENSOR_READING_THRESHOLD_RAW_165MM_WALLS_HARD_CODED \
+    MCI_IR_RAW_FROM_10BIT(63u)
+
+#define MCI_FRONT_SENSOR_READING_THRESHOLD_RAW_180MM_WALLS_HARD_CODED \
+    MCI_IR_RAW_FROM_10BIT(128u)
+#define MCI_LEFT_SENSOR_READING_THRESHOLD_RAW_180MM_WALLS_HARD_CODED \
+    MCI_IR_RAW_FROM_10BIT(101u)
+#define MCI_RIGHT_SENSOR_READING_THRESHOLD_RAW_180MM_WALLS_HARD_CODED \
+    MCI_IR_RAW_FROM_10BIT(101u)
 
 /* hard coded values for 30mm to detect front wall too close */
-#define MCI_FRONT_WALL_TOO_CLOSE_THRESHOLD_RAW_30MM_HARD_CODED           (160)
+#define MCI_FRONT_WALL_TOO_CLOSE_THRESHOLD_RAW_30MM_HARD_CODED \
+    MCI_IR_RAW_FROM_10BIT(160u)
+
+/* front sensor reading w/ mouse centered in a square facing a wall */
+/* tune by running mci_PrintWallSensorReadings() w/ the mouse centered */
+#define MCI_FRONT_WALL_CENTERED_RAW_HARD_CODED \
+    MCI_IR_RAW_FROM_10BIT(145u)
+
+/* side sensor reading w/ mouse centered next to a wall (180mm walls) */
+#define MCI_SIDE_WALL_CENTERED_RAW_HARD_CODED \
+    MCI_IR_RAW_FROM_10BIT(161u)
+
+/* hysteresis around the side thresholds for wall edge detection */
+#define MCI_WALL_EDGE_HYSTERESIS_RAW \
+    MCI_IR_RAW_FROM_10BIT(10u)
+
+/* wall evidence- each reading votes its distance from the threshold in */
+/* hysteresis steps, readings inside the hysteresis band vote 0 */
+#define MCI_WALL_EVIDENCE_VOTE_MAX      (4)
+/* total weight that decides a wall- crossing back needs the opposite bound */
+#define MCI_WALL_EVIDENCE_DECISION      (12)
+/* confidence scale returned by the wall confidence getters */
+#define MCI_WALL_CONFIDENCE_FULL        (100u)
+
+/* confident wall readings in a row against a known wall before the */
+/* sensors behind them are flagged */
+#define MCI_WALL_MAP_DISAGREEMENT_MAX   (3u)
+
+/* bit for one sensor in the failed sensor mask */
+#define MCI_IR_FAILED(sensor)           (1u << (sensor))
+#define MCI_IR_FAILED_FRONT_PAIR \
+    (MCI_IR_FAILED(MCI_IR_SENSOR_LEFT_FRONT) | \
+    MCI_IR_FAILED(MCI_IR_SENSOR_RIGHT_FRONT))
+
+/* how far ahead of mouse center a side sensor meets the side wall */
+/* geometric starting value- 45 degree sensor w/ mouse centered in square */
+#define MCI_SIDE_SENSOR_LOOKAHEAD_MM \
+    ((MCI_MOUSE_LENGTH_MM / 2) + (((MCI_MAZE_SQUARE_LENGTH_MM / 2) - \
+    (MCI_MAZE_PILLAR_WIDTH_MM / 2)) - (MCI_MOUSE_WIDTH_MM / 2) - \
+    MCI_MOUSE_DIAGONAL_SENSOR_OFFSET_MM))
+
+/* thresholds and setpoints in use come from the stored IR calibration */
+/* (see mci_CalibrateIrSensors()), users must include settings_mci.h */
+/* hard coded values above are the defaults before calibration */
 
 /* front sensor threshold raw value */
 #define MCI_FRONT_SENSOR_READING_THRESHOLD_RAW \
-    MCI_FRONT_SENSOR_READING_THRESHOLD_RAW_180MM_WALLS_HARD_CODED
-    //MCI_READING_MM_TO_RAW(MCI_FRONT_SENSOR_READING_THRESHOLD_MM)
+    ((uint32_t)mci_GetSettings()->irCalibration.frontThresholdRaw)
 
 /* left sensor threshold raw value */
 #define MCI_LEFT_SENSOR_READING_THRESHOLD_RAW \
-    MCI_LEFT_SENSOR_READING_THRESHOLD_RAW_180MM_WALLS_HARD_CODED
-    //MCI_LEFT_SENSOR_READING_THRESHOLD_RAW_165MM_WALLS_HARD_CODED
-    //MCI_READING_MM_TO_RAW(MCI_LEFT_SENSOR_READING_THRESHOLD_MM)
+    ((uint32_t)mci_GetSettings()->irCalibration.leftThresholdRaw)
 
 /* right sensor threshold raw value */
 #define MCI_RIGHT_SENSOR_READING_THRESHOLD_RAW \
-    MCI_RIGHT_SENSOR_READING_THRESHOLD_RAW_180MM_WALLS_HARD_CODED
-    //MCI_RIGHT_SENSOR_READING_THRESHOLD_RAW_165MM_WALLS_HARD_CODED
-    //MCI_READING_MM_TO_RAW(MCI_RIGHT_SENSOR_READING_THRESHOLD_MM)
+    ((uint32_t)mci_GetSettings()->irCalibration.rightThresholdRaw)
+
+/* front sensor raw value w/ mouse centered facing a wall */
+#define MCI_FRONT_WALL_CENTERED_RAW \
+    ((uint32_t)mci_GetSettings()->irCalibration.frontCenteredRaw)
+
+/* side sensor raw values w/ mouse centered next to a wall */
+#define MCI_LEFT_WALL_CENTERED_RAW \
+    ((uint32_t)mci_GetSettings()->irCalibration.leftCenteredRaw)
+#define MCI_RIGHT_WALL_CENTERED_RAW \
+    ((uint32_t)mci_GetSettings()->irCalibration.rightCenteredRaw)
 
 /*----------------------------------------------------------------------------*/
 /*                              Global Variables                              */
@@ -100,6 +213,7 @@ void mci_SetFrontWallUpdateAvailable(void);
 void mci_SetLeftWallUpdateAvailable(void);
 void mci_SetRightWallUpdateAvailable(void);
 void mci_ClearLeftRightWallPresence(void);
+void mci_ResetSideWallEvidence(void);
 
 void mci_UpdateFrontWallPresence(void);
 void mci_UpdateLeftWallPresence(void);
@@ -112,4 +226,23 @@ mci_wall_presence_t mci_CheckFrontWall(void);
 mci_wall_presence_t mci_CheckLeftWall(void);
 mci_wall_presence_t mci_CheckRightWall(void);
 
+uint32_t mci_GetFrontWallConfidence(void);
+uint32_t mci_GetLeftWallConfidence(void);
+uint32_t mci_GetRightWallConfidence(void);
+
+void mci_ExpectFrontWall(mci_wall_presence_t expected);
+void mci_ExpectLeftWall(mci_wall_presence_t expected);
+void mci_ExpectRightWall(mci_wall_presence_t expected);
+
+uint32_t mci_GetFailedIrSensors(void);
+uint32_t mci_ReadHealthyIr(uint32_t p_readings[MCI_IR_SENSOR_COUNT]);
+
+void mci_ResetWallEdgeDetection(void);
+mci_wall_edge_t mci_DetectLeftWallEdge(uint32_t reading);
+mci_wall_edge_t mci_DetectRightWallEdge(uint32_t reading);
+
+uint32_t mci_ConvertMmToReading(mci_ir_sensor_t sensor, uint32_t distanceMm);
+uint32_t mci_ConvertReadingToMm(mci_ir_sensor_t sensor, uint32_t reading);
+uint32_t mci_GetWallDistanceMm(mci_ir_sensor_t sensor);
+
 #endif /* WALLDETECTION_MCI_H_ */
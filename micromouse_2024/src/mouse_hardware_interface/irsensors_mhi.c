@@ -30,12 +30,44 @@
 #include "leds_mhi.h"
 #include "HAL/HAL_contracts/adc_contract.h"
 #include "HAL/HAL_configs/adc_config.h"
+#include "shared_functions/fixedpoint_sf.h"
 #include "irsensors_mhi.h"
 
 /*----------------------------------------------------------------------------*/
 /*                                Definitions                                 */
 /*----------------------------------------------------------------------------*/
-/* None */
+#if MHI_IR_READING_BITS != CONFIG_ADC_SAMPLE_BITS
+#error "MHI_IR_READING_BITS does not match the ADC config sample width"
+#endif
+
+/* weight of each new sample for MHI_IR_FILTER_EMA */
+#define MHI_IR_FILTER_EMA_ALPHA    SF_Q16_FROM_FLOAT(0.5f)
+
+/* health checks on unfiltered scans, scan counts at 2 kHz */
+#define MHI_IR_HEALTH_SATURATED_RAW     (MHI_IR_READING_MAX - \
+    (MHI_IR_READING_MAX >> 6))
+#define MHI_IR_HEALTH_SATURATED_SCANS   (2000u)     /* 1 s at full scale */
+/* readings at the floor are steady w/ nothing in view- not stuck */
+#define MHI_IR_HEALTH_STUCK_FLOOR_RAW   (MHI_IR_READING_MAX >> 7)
+#define MHI_IR_HEALTH_STUCK_SCANS       (4000u)     /* 2 s unchanged */
+
+/* reads in a row the ADC driver has to fail before the sensors are */
+/* flagged- one busy or missed read hands back the last scan unflagged */
+#define MHI_IR_ADC_READ_FAILURES_MAX    (3u)
+/* mean squared scan to scan change, averaged over ~2^5 scans */
+#define MHI_IR_HEALTH_NOISE_SHIFT       (5u)
+#define MHI_IR_HEALTH_NOISE_MAX_RAW     (MHI_IR_READING_MAX >> 4)
+#define MHI_IR_HEALTH_NOISE_MAX \
+    (MHI_IR_HEALTH_NOISE_MAX_RAW * MHI_IR_HEALTH_NOISE_MAX_RAW)
+
+/* per sensor health check state, only touched by the scan handler */
+typedef struct
+{
+    uint32_t lastReading;
+    uint32_t stuckScans;
+    uint32_t saturatedScans;
+    uint32_t noise;             /* mean squared scan to scan change */
+} mhi_ir_health_state_t;
 
 /*----------------------------------------------------------------------------*/
 /*                               Debug Switches                               */
@@ -45,12 +77,30 @@
 /*----------------------------------------------------------------------------*/
 /*                              Global Variables                              */
 /*----------------------------------------------------------------------------*/
-/* None */
+/* per sensor filters- only touched by the scan handler */
+static sf_filter_t irFilters[MHI_IR_COUNT];
+static mhi_ir_filter_t irFilterActive = MHI_IR_FILTER_NONE;
+static volatile mhi_ir_filter_t irFilterRequested = MHI_IR_FILTER_DEFAULT;
+static volatile uint32_t irFilterPending = 1u;
+
+/* faults latch until mhi_ResetIrHealth()- signal faults are set by the */
+/* scan handler only, map faults by the main loop only. Stuck faults do */
+/* not latch, a still mouse can see a still wall */
+static mhi_ir_health_state_t irHealthStates[MHI_IR_COUNT];
+static volatile uint32_t irSignalFaults[MHI_IR_COUNT];
+static volatile uint32_t irStuckFaults[MHI_IR_COUNT];
+static volatile uint32_t irMapFaults[MHI_IR_COUNT];
+static volatile uint32_t irHealthResetPending = 1u;
+static uint32_t irAdcFault = 0u;            /* latched, ADC never started */
+static uint32_t irAdcReadFailures = 0u;     /* reads failed in a row */
+static uint32_t irScanSeen = 0u;            /* a scan has been read */
+static uint32_t irLastGoodReadings[MHI_IR_COUNT];
 
 /*----------------------------------------------------------------------------*/
 /*                    Private (Static) Function Prototype                     */
 /*----------------------------------------------------------------------------*/
-/* None */
+static void mhi_FilterIrScan(uint32_t* p_channelValues);
+static void mhi_CheckIrScanHealth(const uint32_t* p_channelValues);
 
 /*----------------------------------------------------------------------------*/
 /*                       Public (Exportable) Functions                        */
@@ -68,16 +118,16 @@ void mhi_DisableIrSensors(void)
     
     if (adcInterface->adc_DisableChannel(MHI_ADC_CHANNEL_MASK_IR1)
         != ADC_SUCCESS)
-        mhi_IndicateError(MHI_LEDS_IR_SENSOR_ERROR);
+        irAdcFault = 1u;
     if (adcInterface->adc_DisableChannel(MHI_ADC_CHANNEL_MASK_IR2)
         != ADC_SUCCESS)
-        mhi_IndicateError(MHI_LEDS_IR_SENSOR_ERROR);
+        irAdcFault = 1u;
     if (adcInterface->adc_DisableChannel(MHI_ADC_CHANNEL_MASK_IR3)
         != ADC_SUCCESS)
-        mhi_IndicateError(MHI_LEDS_IR_SENSOR_ERROR);
+        irAdcFault = 1u;
     if (adcInterface->adc_DisableChannel(MHI_ADC_CHANNEL_MASK_IR4)
         != ADC_SUCCESS)
-        mhi_IndicateError(MHI_LEDS_IR_SENSOR_ERROR);
+        irAdcFault = 1u;
 }
 
 /**
@@ -92,109 +142,198 @@ void mhi_InitAdc(void)
     config_GetAdcHandler(&adcInterface);
     
     if (adcInterface->adc_Init() != ADC_SUCCESS)
-        mhi_IndicateError(MHI_LEDS_IR_SENSOR_ERROR);
+        irAdcFault = 1u;
     
     mhi_DisableIrSensors();
+    
+    /* scans run once global interrupts are enabled */
+    if (adcInterface->adc_SetScanHandler(mhi_FilterIrScan) != ADC_SUCCESS)
+        irAdcFault = 1u;
+    if (adcInterface->adc_StartSampling(MHI_ADC_CHANNEL_MASK_IR_ALL)
+        != ADC_SUCCESS)
+        irAdcFault = 1u;
 }
 
 /**
 * Initialize IR sensor receiver pins for micromouse.
 *
 * \param  None
-* \retval sensorReading ADC sensor reading from IR receiver 1
+* \retval latest ADC sensor reading from IR receiver 1
 */
 uint32_t mhi_ReadIr1(void)
 {
-    uint32_t sensorReading = 0u;
-    adc_handler_t *adcInterface = NULL;
-    config_GetAdcHandler(&adcInterface);
+    uint32_t readings[MHI_IR_COUNT] = {0u};
     
-    if (adcInterface->adc_EnableChannel(MHI_ADC_CHANNEL_MASK_IR1)
-        != ADC_SUCCESS)
-        mhi_IndicateError(MHI_LEDS_IR_SENSOR_ERROR);
-    if (adcInterface->adc_ReadValue(0u, &sensorReading) 
-        != ADC_SUCCESS)
-        mhi_IndicateError(MHI_LEDS_IR_SENSOR_ERROR);
-    if (adcInterface->adc_DisableChannel(MHI_ADC_CHANNEL_MASK_IR1)
-        != ADC_SUCCESS)
-        mhi_IndicateError(MHI_LEDS_IR_SENSOR_ERROR);
-        
-    return sensorReading;
+    mhi_ReadAllIr(readings);
+    
+    return readings[MHI_IR1_INDEX];
 }
 
 /**
 * Initialize IR sensor receiver pins for micromouse.
 *
 * \param  None
-* \retval sensorReading ADC sensor reading from IR receiver 2
+* \retval latest ADC sensor reading from IR receiver 2
 */
 uint32_t mhi_ReadIr2(void)
 {
-    uint32_t sensorReading = 0u;
-    adc_handler_t *adcInterface = NULL;
-    config_GetAdcHandler(&adcInterface);
+    uint32_t readings[MHI_IR_COUNT] = {0u};
     
-    if (adcInterface->adc_EnableChannel(MHI_ADC_CHANNEL_MASK_IR2)
-        != ADC_SUCCESS)
-        mhi_IndicateError(MHI_LEDS_IR_SENSOR_ERROR);
-    if (adcInterface->adc_ReadValue(0u, &sensorReading)
-        != ADC_SUCCESS)
-        mhi_IndicateError(MHI_LEDS_IR_SENSOR_ERROR);
-    if (adcInterface->adc_DisableChannel(MHI_ADC_CHANNEL_MASK_IR2)
-        != ADC_SUCCESS)
-        mhi_IndicateError(MHI_LEDS_IR_SENSOR_ERROR);
-        
-    return sensorReading;
+    mhi_ReadAllIr(readings);
+    
+    return readings[MHI_IR2_INDEX];
 }
 
 /**
 * Initialize IR sensor receiver pins for micromouse.
 *
 * \param  None
-* \retval sensorReading ADC sensor reading from IR receiver 3
+* \retval latest ADC sensor reading from IR receiver 3
 */
 uint32_t mhi_ReadIr3(void)
 {
-    uint32_t sensorReading = 0u;
-    adc_handler_t *adcInterface = NULL;
-    config_GetAdcHandler(&adcInterface);
+    uint32_t readings[MHI_IR_COUNT] = {0u};
     
-    if (adcInterface->adc_EnableChannel(MHI_ADC_CHANNEL_MASK_IR3)
-        != ADC_SUCCESS)
-        mhi_IndicateError(MHI_LEDS_IR_SENSOR_ERROR);
-    if (adcInterface->adc_ReadValue(0u, &sensorReading)
-        != ADC_SUCCESS)
-        mhi_IndicateError(MHI_LEDS_IR_SENSOR_ERROR);
-    if (adcInterface->adc_DisableChannel(MHI_ADC_CHANNEL_MASK_IR3)
-        != ADC_SUCCESS)
-        mhi_IndicateError(MHI_LEDS_IR_SENSOR_ERROR);
-        
-    return sensorReading;
+    mhi_ReadAllIr(readings);
+    
+    return readings[MHI_IR3_INDEX];
 }
 
 /**
 * Initialize IR sensor receiver pins for micromouse.
 *
 * \param  None
-* \retval sensorReading ADC sensor reading from IR receiver 4
+* \retval latest ADC sensor reading from IR receiver 4
 */
 uint32_t mhi_ReadIr4(void)
 {
-    uint32_t sensorReading = 0u;
+    uint32_t readings[MHI_IR_COUNT] = {0u};
+    
+    mhi_ReadAllIr(readings);
+    
+    return readings[MHI_IR4_INDEX];
+}
+
+/**
+* Read the latest background scan of all IR sensor receivers.
+*
+* Returns at once w/ the newest complete set of readings, all four from the
+* same scan. Results come back in ADC channel order and are put in IR order
+* here. Readings are 0 until the first scan after interrupts are enabled,
+* and every sensor reports an ADC fault until then.
+*
+* \param[out] p_readings ADC sensor readings, see MHI_IR1_INDEX etc.
+* \retval None
+*/
+void mhi_ReadAllIr(uint32_t p_readings[MHI_IR_COUNT])
+{
+    /* channel order: IR1 (1), IR2 (2), IR4 (4), IR3 (5) */
+    uint32_t channelReadings[MHI_IR_COUNT] = {0u};
+    uint32_t sequence = 0u;
     adc_handler_t *adcInterface = NULL;
     config_GetAdcHandler(&adcInterface);
     
-    if (adcInterface->adc_EnableChannel(MHI_ADC_CHANNEL_MASK_IR4)
-        != ADC_SUCCESS)
-        mhi_IndicateError(MHI_LEDS_IR_SENSOR_ERROR);
-    if (adcInterface->adc_ReadValue(0u, &sensorReading)
-        != ADC_SUCCESS)
-        mhi_IndicateError(MHI_LEDS_IR_SENSOR_ERROR);
-    if (adcInterface->adc_DisableChannel(MHI_ADC_CHANNEL_MASK_IR4)
-        != ADC_SUCCESS)
-        mhi_IndicateError(MHI_LEDS_IR_SENSOR_ERROR);
-        
-    return sensorReading;
+    uint32_t i = 0u;
+    
+    /* a failed read hands back the last good scan, the sensors are only */
+    /* flagged once reads keep failing */
+    if (adcInterface->adc_ReadSamples(MHI_ADC_CHANNEL_MASK_IR_ALL, 
+        channelReadings, &sequence) != ADC_SUCCESS)
+    {
+        if (irAdcReadFailures < MHI_IR_ADC_READ_FAILURES_MAX)
+            irAdcReadFailures++;
+        for (i = 0u; i < MHI_IR_COUNT; i++)
+        {
+            p_readings[i] = irLastGoodReadings[i];
+        }
+        return;
+    }
+    irAdcReadFailures = 0u;
+    irScanSeen = 1u;
+    
+    p_readings[MHI_IR1_INDEX] = channelReadings[0];
+    p_readings[MHI_IR2_INDEX] = channelReadings[1];
+    p_readings[MHI_IR4_INDEX] = channelReadings[2];
+    p_readings[MHI_IR3_INDEX] = channelReadings[3];
+    
+    for (i = 0u; i < MHI_IR_COUNT; i++)
+    {
+        irLastGoodReadings[i] = p_readings[i];
+    }
+}
+
+/**
+* Pick the filter run on every IR sensor scan.
+*
+* Takes effect w/ the next scan; each sensor's filter restarts from that
+* scan so no samples from the old filter carry over.
+*
+* \param[in] filter Filter to run
+* \retval None
+*/
+void mhi_SetIrFilter(mhi_ir_filter_t filter)
+{
+    irFilterRequested = filter;
+    irFilterPending = 1u;
+}
+
+/**
+* Get the faults seen on an IR sensor receiver.
+*
+* Faults latch until mhi_ResetIrHealth(), a sensor that misbehaved once is
+* not trusted again during the run. Stuck clears once the reading moves, and
+* ADC read faults clear w/ the next good read.
+*
+* \param[in] irIndex Sensor to check, see MHI_IR1_INDEX etc.
+* \retval MHI_IR_HEALTHY No faults
+* \retval other MHI_IR_FAULT_ bits seen on the sensor
+*/
+uint32_t mhi_GetIrHealth(uint32_t irIndex)
+{
+    uint32_t faults = MHI_IR_HEALTHY;
+    
+    if (irIndex >= MHI_IR_COUNT)
+        return MHI_IR_FAULT_ADC;
+    
+    /* no scan read yet- the readings are not real */
+    if (irAdcFault || (!irScanSeen) || 
+        (irAdcReadFailures >= MHI_IR_ADC_READ_FAILURES_MAX))
+        faults |= MHI_IR_FAULT_ADC;
+    
+    return faults | irSignalFaults[irIndex] | irStuckFaults[irIndex] | 
+        irMapFaults[irIndex];
+}
+
+/**
+* Flag an IR sensor receiver that keeps contradicting known walls.
+*
+* \param[in] irIndex Sensor to flag, see MHI_IR1_INDEX etc.
+* \retval None
+*/
+void mhi_SetIrMapFault(uint32_t irIndex)
+{
+    if (irIndex < MHI_IR_COUNT)
+        irMapFaults[irIndex] = MHI_IR_FAULT_MAP;
+}
+
+/**
+* Clear all IR sensor faults except an ADC that never started.
+*
+* Signal checks start over w/ the next scan.
+*
+* \param  None
+* \retval None
+*/
+void mhi_ResetIrHealth(void)
+{
+    uint32_t i = 0u;
+    
+    for (i = 0u; i < MHI_IR_COUNT; i++)
+    {
+        irMapFaults[i] = MHI_IR_HEALTHY;
+    }
+    irAdcReadFailures = 0u;
+    irHealthResetPending = 1u;
 }
 
 /*----------------------------------------------------------------------------*/
@@ -205,4 +344,132 @@ uint32_t mhi_ReadIr4(void)
 /*----------------------------------------------------------------------------*/
 /*                         Private (Static) Functions                         */
 /*----------------------------------------------------------------------------*/
-/* None */
+/**
+* Check and filter one background scan of the IR sensors in place.
+*
+* Runs in the ADC interrupt before the scan is published, so every reader
+* only ever sees filtered readings. Health checks see the unfiltered scan
+* so spikes and noise are not hidden from them.
+*
+* \param[in,out] p_channelValues Scan values indexed by ADC channel number
+* \retval None
+*/
+static void mhi_FilterIrScan(uint32_t* p_channelValues)
+{
+    static const uint32_t channels[MHI_IR_COUNT] = 
+    {
+        MHI_ADC_CHANNEL_IR1, MHI_ADC_CHANNEL_IR2,
+        MHI_ADC_CHANNEL_IR3, MHI_ADC_CHANNEL_IR4
+    };
+    sf_filter_type_t type = SF_FILTER_NONE;
+    uint32_t i = 0u;
+    
+    mhi_CheckIrScanHealth(p_channelValues);
+    
+    if (irFilterPending)
+    {
+        irFilterPending = 0u;
+        irFilterActive = irFilterRequested;
+        
+        if (irFilterActive == MHI_IR_FILTER_MEDIAN3)
+            type = SF_FILTER_MEDIAN3;
+        else if (irFilterActive == MHI_IR_FILTER_EMA)
+            type = SF_FILTER_EMA;
+        else if (irFilterActive == MHI_IR_FILTER_AVERAGE4)
+            type = SF_FILTER_AVERAGE4;
+        
+        for (i = 0u; i < MHI_IR_COUNT; i++)
+        {
+            sf_InitFilter(&irFilters[i], type, MHI_IR_FILTER_EMA_ALPHA);
+        }
+    }
+    
+    for (i = 0u; i < MHI_IR_COUNT; i++)
+    {
+        p_channelValues[channels[i]] = (uint32_t)sf_UpdateFilter(
+            &irFilters[i], (int32_t)p_channelValues[channels[i]]);
+    }
+}
+
+/**
+* Look for saturated, stuck and noisy IR sensors in one unfiltered scan.
+*
+* Runs in the ADC interrupt.
+*
+* \param[in] p_channelValues Scan values indexed by ADC channel number
+* \retval None
+*/
+static void mhi_CheckIrScanHealth(const uint32_t* p_channelValues)
+{
+    static const uint32_t channels[MHI_IR_COUNT] = 
+    {
+        MHI_ADC_CHANNEL_IR1, MHI_ADC_CHANNEL_IR2,
+        MHI_ADC_CHANNEL_IR3, MHI_ADC_CHANNEL_IR4
+    };
+    mhi_ir_health_state_t *p_state = NULL;
+    uint32_t reading = 0u;
+    uint32_t change = 0u;
+    uint32_t i = 0u;
+    
+    if (irHealthResetPending)
+    {
+        irHealthResetPending = 0u;
+        for (i = 0u; i < MHI_IR_COUNT; i++)
+        {
+            irHealthStates[i].lastReading = 
+                p_channelValues[channels[i]];
+            irHealthStates[i].stuckScans = 0u;
+            irHealthStates[i].saturatedScans = 0u;
+            irHealthStates[i].noise = 0u;
+            irSignalFaults[i] = MHI_IR_HEALTHY;
+            irStuckFaults[i] = MHI_IR_HEALTHY;
+        }
+        return;
+    }
+    
+    for (i = 0u; i < MHI_IR_COUNT; i++)
+    {
+        p_state = &irHealthStates[i];
+        reading = p_channelValues[channels[i]];
+        change = (reading > p_state->lastReading) ? 
+            (reading - p_state->lastReading) : 
+            (p_state->lastReading - reading);
+        
+        /* out of range- pinned at the top of the ADC range */
+        if (reading >= MHI_IR_HEALTH_SATURATED_RAW)
+        {
+            if (++p_state->saturatedScans >= MHI_IR_HEALTH_SATURATED_SCANS)
+                irSignalFaults[i] |= MHI_IR_FAULT_SATURATED;
+        }
+        else
+        {
+            p_state->saturatedScans = 0u;
+        }
+        
+        /* stuck- oversampled readings always wobble w/ something in view */
+        if ((change == 0u) && (reading > MHI_IR_HEALTH_STUCK_FLOOR_RAW))
+        {
+            if (p_state->stuckScans < MHI_IR_HEALTH_STUCK_SCANS)
+                p_state->stuckScans++;
+            else
+                irStuckFaults[i] = MHI_IR_FAULT_STUCK;
+        }
+        else
+        {
+            p_state->stuckScans = 0u;
+            irStuckFaults[i] = MHI_IR_HEALTHY;
+        }
+        
+        /* noisy- running mean of the squared change, clamped so the */
+        /* square stays inside 32 bits */
+        if (change > MHI_IR_HEALTH_NOISE_MAX_RAW * 4u)
+            change = MHI_IR_HEALTH_NOISE_MAX_RAW * 4u;
+        p_state->noise = p_state->noise - 
+            (p_state->noise >> MHI_IR_HEALTH_NOISE_SHIFT) + 
+            ((change * change) >> MHI_IR_HEALTH_NOISE_SHIFT);
+        if (p_state->noise > MHI_IR_HEALTH_NOISE_MAX)
+            irSignalFaults[i] |= MHI_IR_FAULT_NOISY;
+        
+        p_state->lastReading = reading;
+    }
+}
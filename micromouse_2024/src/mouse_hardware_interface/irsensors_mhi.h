@@ -39,6 +39,42 @@
 #define MHI_ADC_CHANNEL_MASK_IR2 (1 << MHI_ADC_CHANNEL_IR2) /* IR1 ADC mask */
 #define MHI_ADC_CHANNEL_MASK_IR3 (1 << MHI_ADC_CHANNEL_IR3) /* IR1 ADC mask */
 #define MHI_ADC_CHANNEL_MASK_IR4 (1 << MHI_ADC_CHANNEL_IR4) /* IR1 ADC mask */
+#define MHI_ADC_CHANNEL_MASK_IR_ALL (MHI_ADC_CHANNEL_MASK_IR1 | \
+    MHI_ADC_CHANNEL_MASK_IR2 | MHI_ADC_CHANNEL_MASK_IR3 | \
+    MHI_ADC_CHANNEL_MASK_IR4)
+
+/* mhi_ReadAllIr() output slots */
+#define MHI_IR1_INDEX    (0u)
+#define MHI_IR2_INDEX    (1u)
+#define MHI_IR3_INDEX    (2u)
+#define MHI_IR4_INDEX    (3u)
+#define MHI_IR_COUNT     (4u)
+
+/* bits per reading- the ADC config's sample width, checked against */
+/* CONFIG_ADC_SAMPLE_BITS when irsensors_mhi.c is built */
+#define MHI_IR_READING_BITS    (13u)
+#define MHI_IR_READING_MAX     ((1u << MHI_IR_READING_BITS) - 1u)
+
+/* IR sensor health, fault bits returned by mhi_GetIrHealth() */
+#define MHI_IR_HEALTHY            (0x00u)
+#define MHI_IR_FAULT_ADC          (0x01u)    /* ADC failed to start or read */
+#define MHI_IR_FAULT_SATURATED    (0x02u)    /* pinned at full scale */
+#define MHI_IR_FAULT_STUCK        (0x04u)    /* same reading for too long */
+#define MHI_IR_FAULT_NOISY        (0x08u)    /* scan to scan variance high */
+#define MHI_IR_FAULT_MAP          (0x10u)    /* keeps contradicting the map */
+
+/* filter run on every background scan, delay at 2 kHz scans */
+typedef enum
+{
+    MHI_IR_FILTER_NONE = 0u,        /* raw samples, no delay */
+    MHI_IR_FILTER_MEDIAN3,          /* drops lone spikes, 0.5 ms */
+    MHI_IR_FILTER_EMA,              /* alpha 1/2, 0.5 ms */
+    MHI_IR_FILTER_AVERAGE4          /* 0.75 ms */
+} mhi_ir_filter_t;
+
+/* filter used from startup until mhi_SetIrFilter() is called */
+#define MHI_IR_FILTER_DEFAULT    MHI_IR_FILTER_MEDIAN3
+
 /*----------------------------------------------------------------------------*/
 /*                              Global Variables                              */
 /*----------------------------------------------------------------------------*/
@@ -53,5 +89,10 @@ uint32_t mhi_ReadIr1(void);         /* initialize LEDs */
 uint32_t mhi_ReadIr2(void);         /* initialize LEDs */
 uint32_t mhi_ReadIr3(void);         /* initialize LEDs */
 uint32_t mhi_ReadIr4(void);         /* initialize LEDs */
+void mhi_ReadAllIr(uint32_t p_readings[MHI_IR_COUNT]); /* one scan of all */
+void mhi_SetIrFilter(mhi_ir_filter_t filter); /* pick IR filter */
+uint32_t mhi_GetIrHealth(uint32_t irIndex);   /* IR sensor fault bits */
+void mhi_SetIrMapFault(uint32_t irIndex);     /* flag map disagreement */
+void mhi_ResetIrHealth(void);                 /* clear IR sensor faults */
 
 #endif /* IRSENSORS_MHI_H_ */
\ No newline at end of file
@@ -318,6 +318,18 @@ void mhi_IndicateError(const mhi_error_type_t error)
             clockInterface->clock_DelayMs(500);
         }
     }
+    else if (error == MHI_LEDS_STORAGE_ERROR)
+    {
+        while(1)
+        {
+            mhi_SetD2Led();
+            mhi_SetD3Led();
+            clockInterface->clock_DelayMs(500);
+            mhi_ClearD2Led();
+            mhi_ClearD3Led();
+            clockInterface->clock_DelayMs(500);
+        }
+    }
 }
 
 /*----------------------------------------------------------------------------*/
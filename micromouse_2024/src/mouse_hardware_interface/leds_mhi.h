@@ -37,7 +37,8 @@ typedef enum
     MHI_LEDS_USART_ERROR,
     MHI_LEDS_LOW_BATTERY_ERROR,
     MHI_LEDS_IR_SENSOR_ERROR,
-    MHI_LEDS_PWM_ERROR
+    MHI_LEDS_PWM_ERROR,
+    MHI_LEDS_STORAGE_ERROR
 } mhi_error_type_t;
 
 /*----------------------------------------------------------------------------*/
@@ -37,7 +37,8 @@
 /*----------------------------------------------------------------------------*/
 /*                                Definitions                                 */
 /*----------------------------------------------------------------------------*/
-/* None */
+/* wheel motor driver drives CLD high while it limits motor current */
+#define MHI_WHEEL_MOTOR_CLD_ACTIVE_STATE    IO_PIN_HIGH
 
 /*----------------------------------------------------------------------------*/
 /*                               Debug Switches                               */
@@ -279,6 +280,66 @@ mhi_wheel_motor_direction_t mhi_GetWheelMotor2Direction(void)
     return wheelMotor2Direction;
 }
 
+/**
+* Set both micromouse wheel motors w/ signed duty cycles.
+*
+* Both duty cycles go out in one PWM write. Direction pins are only written
+* when a wheel's sign changes- a speed of 0 keeps the last direction.
+*
+* \param[in] leftSpeed Signed duty cycle for wheel motor 1 (-255~255)
+* \param[in] rightSpeed Signed duty cycle for wheel motor 2 (-255~255)
+* \retval None
+*/
+void mhi_SetWheelSpeeds(int16_t leftSpeed, int16_t rightSpeed)
+{
+    pwm_handler_t *pwmInterface = NULL;
+    config_GetPwmHandler(&pwmInterface);
+    
+    /* wheel motor 1 direction */
+    if ((leftSpeed > 0) && 
+        (wheelMotor1Direction != MHI_WHEEL_MOTOR_DIRECTION_FORWARD))
+        mhi_StartWheelMotor1Forward();
+    else if ((leftSpeed < 0) && 
+        (wheelMotor1Direction != MHI_WHEEL_MOTOR_DIRECTION_BACKWARD))
+        mhi_StartWheelMotor1Backward();
+    
+    /* wheel motor 2 direction */
+    if ((rightSpeed > 0) && 
+        (wheelMotor2Direction != MHI_WHEEL_MOTOR_DIRECTION_FORWARD))
+        mhi_StartWheelMotor2Forward();
+    else if ((rightSpeed < 0) && 
+        (wheelMotor2Direction != MHI_WHEEL_MOTOR_DIRECTION_BACKWARD))
+        mhi_StartWheelMotor2Backward();
+    
+    if (pwmInterface->pwm_SetWheelMotorDutyCycles(
+        (uint16_t)((leftSpeed < 0) ? -leftSpeed : leftSpeed),
+        (uint16_t)((rightSpeed < 0) ? -rightSpeed : rightSpeed)) != 
+        PWM_SUCCESS)
+        mhi_IndicateError(MHI_LEDS_PWM_ERROR);
+}
+
+/**
+* Check whether the wheel motor driver is limiting motor current.
+*
+* The driver limits current when a wheel is held still under drive, e.g.
+* when the mouse is pushing against a wall.
+*
+* \param  None
+* \retval MHI_WHEEL_MOTOR_CURRENT_LIMITED CLD pin is asserted
+* \retval MHI_WHEEL_MOTOR_CURRENT_OK CLD pin is not asserted
+*/
+mhi_wheel_motor_current_t mhi_CheckWheelMotorCurrentLimit(void)
+{
+    io_pin_state_t pinState = IO_PIN_LOW;
+    io_handler_t *ioInterface = NULL;
+    config_GetIOHandler(&ioInterface);
+    
+    ioInterface->io_ReadInput(0u, MHI_WHEEL_MOTOR_CLD_PIN, &pinState);
+    
+    return (pinState == MHI_WHEEL_MOTOR_CLD_ACTIVE_STATE) ? 
+        MHI_WHEEL_MOTOR_CURRENT_LIMITED : MHI_WHEEL_MOTOR_CURRENT_OK;
+}
+
 /**
 * Start micromouse vacuum motor w/ given duty cycle.
 *
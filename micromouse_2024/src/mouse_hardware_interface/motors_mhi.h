@@ -45,6 +45,13 @@ typedef enum
     MHI_WHEEL_MOTOR_DIRECTION_BACKWARD,
 } mhi_wheel_motor_direction_t;
 
+/* wheel motor driver current limit detect */
+typedef enum
+{
+    MHI_WHEEL_MOTOR_CURRENT_OK = 0u,
+    MHI_WHEEL_MOTOR_CURRENT_LIMITED
+} mhi_wheel_motor_current_t;
+
 /* vacuum motor state */
 typedef enum 
 {
@@ -76,6 +83,9 @@ void mhi_SetWheelMotor2Speed(uint16_t speed);
 void mhi_StopWheelMotor2(void);
 mhi_wheel_motor_direction_t mhi_GetWheelMotor2Direction(void);
 
+void mhi_SetWheelSpeeds(int16_t leftSpeed, int16_t rightSpeed);
+mhi_wheel_motor_current_t mhi_CheckWheelMotorCurrentLimit(void);
+
 void mhi_StartVacuumMotor(uint16_t speed);
 void mhi_StopVacuumMotor(void);
 mhi_vacuum_motor_state_t mhi_GetVacuumMotorState(void);
@@ -0,0 +1,113 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : storage_mhi.c
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-04-07
+* Purpose         : mouse hardware interface layer
+*
+* This is the source file for the mouse nonvolatile storage interface.
+*
+* The mouse hardware interface uses the HAL to define functions needed to
+* interface w/ all mouse hardware.
+*-----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include "leds_mhi.h"
+#include "HAL/HAL_contracts/flash_contract.h"
+#include "HAL/HAL_configs/flash_config.h"
+#include "storage_mhi.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                               Debug Switches                               */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                    Private (Static) Function Prototype                     */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+/**
+* Initialize nonvolatile storage for micromouse.
+*
+* \param  None
+* \retval None
+*/
+void mhi_InitStorage(void)
+{
+    flash_handler_t *flashInterface = NULL;
+    config_GetFlashHandler(&flashInterface);
+    
+    if (flashInterface->flash_Init() == FLASH_ERROR)
+    {
+        mhi_IndicateError(MHI_LEDS_STORAGE_ERROR);
+    }
+}
+
+/**
+* Read bytes from nonvolatile storage for micromouse.
+*
+* Storage is never written until settings are first saved, so callers must
+* validate what they read.
+*
+* \param[out] p_data Buffer to copy stored bytes into
+* \param[in] size Number of bytes to read
+* \retval None
+*/
+void mhi_ReadStorage(void* p_data, uint32_t size)
+{
+    flash_handler_t *flashInterface = NULL;
+    config_GetFlashHandler(&flashInterface);
+    
+    if (flashInterface->flash_Read(p_data, size) == FLASH_ERROR)
+    {
+        mhi_IndicateError(MHI_LEDS_STORAGE_ERROR);
+    }
+}
+
+/**
+* Write bytes to nonvolatile storage for micromouse.
+*
+* Blocks for a page erase and write- do not call while moving.
+*
+* \param[in] p_data Bytes to store
+* \param[in] size Number of bytes to write
+* \retval None
+*/
+void mhi_WriteStorage(const void* p_data, uint32_t size)
+{
+    flash_handler_t *flashInterface = NULL;
+    config_GetFlashHandler(&flashInterface);
+    
+    if (flashInterface->flash_Write(p_data, size) == FLASH_ERROR)
+    {
+        mhi_IndicateError(MHI_LEDS_STORAGE_ERROR);
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/*                           Local Shared Functions                           */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                         Private (Static) Functions                         */
+/*----------------------------------------------------------------------------*/
+/* None */
@@ -0,0 +1,34 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : storage_mhi.h
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-04-07
+* Purpose         : mouse hardware interface layer
+*
+* This is the header file for the mouse nonvolatile storage interface.
+*
+* The mouse hardware interface uses the HAL to define functions needed to
+* interface w/ all mouse hardware.
+*-----------------------------------------------------------------------------*/ 
+
+#ifndef STORAGE_MHI_H_
+#define STORAGE_MHI_H_
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+void mhi_InitStorage(void);                             /* init storage */
+void mhi_ReadStorage(void* p_data, uint32_t size);      /* read bytes */
+void mhi_WriteStorage(const void* p_data, uint32_t size); /* write bytes */
+
+#endif /* STORAGE_MHI_H_ */
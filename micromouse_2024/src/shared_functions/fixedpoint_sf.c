@@ -0,0 +1,419 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : fixedpoint_sf.c
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-04-13
+* Purpose         : shared functions layer
+*
+* This is the source file for the fixed point math, PID and filter functions.
+*
+* Shared functions are used by the mouse control interface for generic
+* functionality.
+*-----------------------------------------------------------------------------*/ 
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include "shared_functions/fixedpoint_sf.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+/* sine table covers one quarter turn, interpolated between entries */
+#define SF_SIN_TABLE_SIZE_BITS    (6)
+#define SF_SIN_TABLE_SIZE         (1 << SF_SIN_TABLE_SIZE_BITS)
+#define SF_SIN_TABLE_STEP_BITS    (14 - SF_SIN_TABLE_SIZE_BITS)
+
+/*----------------------------------------------------------------------------*/
+/*                               Debug Switches                               */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+/* sin(0~90 degrees) in Q16.16 */
+static const sf_q16_t sf_sinTable[SF_SIN_TABLE_SIZE + 1] =
+{
+    0, 1608, 3216, 4821, 6424, 8022, 9616, 11204,
+    12785, 14359, 15924, 17479, 19024, 20557, 22078, 23586,
+    25080, 26558, 28020, 29466, 30893, 32303, 33692, 35062,
+    36410, 37736, 39040, 40320, 41576, 42806, 44011, 45190,
+    46341, 47464, 48559, 49624, 50660, 51665, 52639, 53581,
+    54491, 55368, 56212, 57022, 57798, 58538, 59244, 59914,
+    60547, 61145, 61705, 62228, 62714, 63162, 63572, 63944,
+    64277, 64571, 64827, 65043, 65220, 65358, 65457, 65516,
+    65536
+};
+
+/*----------------------------------------------------------------------------*/
+/*                    Private (Static) Function Prototype                     */
+/*----------------------------------------------------------------------------*/
+static int64_t sf_RoundShiftQ16(int64_t userValue);
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+/**
+* Clamp a wide intermediate result into the Q16.16 range
+*
+* \param[in] userValue 64 bit value to saturate
+* \retval saturated Q16.16 value
+*/
+sf_q16_t sf_Q16Saturate(int64_t userValue)
+{
+    if (userValue > (int64_t)SF_Q16_MAX)
+        return SF_Q16_MAX;
+    else if (userValue < (int64_t)SF_Q16_MIN)
+        return SF_Q16_MIN;
+    else
+        return (sf_q16_t)userValue;
+}
+
+/**
+* Multiply two Q16.16 numbers w/ rounding and saturation
+*
+* \param[in] a First factor
+* \param[in] b Second factor
+* \retval saturated Q16.16 product
+*/
+sf_q16_t sf_Q16Mul(sf_q16_t a, sf_q16_t b)
+{
+    return sf_Q16Saturate(sf_RoundShiftQ16((int64_t)a * (int64_t)b));
+}
+
+/**
+* Divide two Q16.16 numbers w/ saturation
+*
+* Division is slow on the UC3L so keep this out of control loops.
+*
+* \param[in] a Dividend
+* \param[in] b Divisor
+* \retval saturated Q16.16 quotient, saturated by sign of a if b is zero
+*/
+sf_q16_t sf_Q16Div(sf_q16_t a, sf_q16_t b)
+{
+    if (b == 0)
+        return (a >= 0) ? SF_Q16_MAX : SF_Q16_MIN;
+
+    return sf_Q16Saturate(((int64_t)a * SF_Q16_ONE) / b);
+}
+
+/**
+* Scale an integer by a Q16.16 gain, rounded to the nearest integer
+*
+* \param[in] gain Q16.16 gain
+* \param[in] userValue Integer to scale
+* \retval saturated integer product
+*/
+int32_t sf_Q16MulInt(sf_q16_t gain, int32_t userValue)
+{
+    return sf_Q16Saturate(sf_RoundShiftQ16((int64_t)gain * userValue));
+}
+
+/**
+* Get the sine of a binary angle from the quarter wave table
+*
+* \param[in] angle Binary angle, 65536 counts per turn
+* \retval sine in Q16.16
+*/
+sf_q16_t sf_Q16Sin(sf_angle_t angle)
+{
+    uint32_t quarterAngle = angle & (SF_ANGLE_90_DEGREES - 1u);
+    uint32_t index = 0u;
+    uint32_t fraction = 0u;
+    sf_q16_t value = 0;
+    
+    /* mirror second and fourth quarters onto the first */
+    if (angle & SF_ANGLE_90_DEGREES)
+        quarterAngle = SF_ANGLE_90_DEGREES - quarterAngle;
+    
+    index = quarterAngle >> SF_SIN_TABLE_STEP_BITS;
+    fraction = quarterAngle & ((1u << SF_SIN_TABLE_STEP_BITS) - 1u);
+    value = sf_sinTable[index];
+    if (index < SF_SIN_TABLE_SIZE)
+    {
+        value += (sf_q16_t)(((sf_sinTable[index + 1u] - sf_sinTable[index])
+            * (int32_t)fraction) >> SF_SIN_TABLE_STEP_BITS);
+    }
+    
+    /* negate third and fourth quarters */
+    return (angle & SF_ANGLE_180_DEGREES) ? -value : value;
+}
+
+/**
+* Get the cosine of a binary angle
+*
+* \param[in] angle Binary angle, 65536 counts per turn
+* \retval cosine in Q16.16
+*/
+sf_q16_t sf_Q16Cos(sf_angle_t angle)
+{
+    return sf_Q16Sin((sf_angle_t)(angle + SF_ANGLE_90_DEGREES));
+}
+
+/**
+* Set the gains and output limits of a PID controller and clear its state
+*
+* \param[in] p_pid Pointer to the controller
+* \param[in] kp Proportional gain
+* \param[in] ki Integral gain, applied once per update
+* \param[in] kd Derivative gain, applied once per update
+* \param[in] outputMin Lowest output the controller may return
+* \param[in] outputMax Highest output the controller may return
+* \retval None
+*/
+void sf_InitPid(sf_pid_t *p_pid, sf_q16_t kp, sf_q16_t ki, sf_q16_t kd,
+    int32_t outputMin, int32_t outputMax)
+{
+    p_pid->kp = kp;
+    p_pid->ki = ki;
+    p_pid->kd = kd;
+    p_pid->outputMin = outputMin;
+    p_pid->outputMax = outputMax;
+    
+    sf_ResetPid(p_pid);
+}
+
+/**
+* Change the gains of a running PID controller
+*
+* The integrator holds the accumulated term rather than the error sum, so
+* the output does not jump when the gains change between updates.
+*
+* \param[in] p_pid Pointer to the controller
+* \param[in] kp Proportional gain
+* \param[in] ki Integral gain, applied once per update
+* \param[in] kd Derivative gain, applied once per update
+* \retval None
+*/
+void sf_SetPidGains(sf_pid_t *p_pid, sf_q16_t kp, sf_q16_t ki, sf_q16_t kd)
+{
+    p_pid->kp = kp;
+    p_pid->ki = ki;
+    p_pid->kd = kd;
+}
+
+/**
+* Clear the integrator and derivative history of a PID controller
+*
+* \param[in] p_pid Pointer to the controller
+* \retval None
+*/
+void sf_ResetPid(sf_pid_t *p_pid)
+{
+    p_pid->integrator = 0;
+    p_pid->prevError = 0;
+}
+
+/**
+* Run one update of a PID controller
+*
+* The integrator is held inside the output limits so it cannot wind up while
+* the output is saturated.
+*
+* \param[in] p_pid Pointer to the controller
+* \param[in] error Setpoint minus measurement for this control tick
+* \retval saturated controller output
+*/
+int32_t sf_UpdatePid(sf_pid_t *p_pid, int32_t error)
+{
+    int64_t output = 0;
+    int64_t integrator = 0;
+    int64_t integratorMin = (int64_t)p_pid->outputMin * SF_Q16_ONE;
+    int64_t integratorMax = (int64_t)p_pid->outputMax * SF_Q16_ONE;
+    
+    if (p_pid->ki != 0)
+    {
+        integrator = (int64_t)p_pid->integrator
+            + ((int64_t)p_pid->ki * error);
+        
+        if (integrator > integratorMax)
+            integrator = integratorMax;
+        else if (integrator < integratorMin)
+            integrator = integratorMin;
+        
+        p_pid->integrator = sf_Q16Saturate(integrator);
+    }
+    
+    output = ((int64_t)p_pid->kp * error)
+        + ((int64_t)p_pid->kd * ((int64_t)error - p_pid->prevError))
+        + p_pid->integrator;
+    output = sf_RoundShiftQ16(output);
+    
+    p_pid->prevError = error;
+    
+    if (output > p_pid->outputMax)
+        return p_pid->outputMax;
+    else if (output < p_pid->outputMin)
+        return p_pid->outputMin;
+    else
+        return (int32_t)output;
+}
+
+/**
+* Set the smoothing of a low pass filter and clear its state
+*
+* \param[in] p_filter Pointer to the filter
+* \param[in] alpha Weight of each new sample, SF_Q16_ONE disables filtering
+* \retval None
+*/
+void sf_InitLowPass(sf_lowpass_t *p_filter, sf_q16_t alpha)
+{
+    p_filter->alpha = alpha;
+    sf_ResetLowPass(p_filter);
+}
+
+/**
+* Clear a low pass filter so the next sample is loaded directly
+*
+* \param[in] p_filter Pointer to the filter
+* \retval None
+*/
+void sf_ResetLowPass(sf_lowpass_t *p_filter)
+{
+    p_filter->state = 0;
+    p_filter->primed = 0u;
+}
+
+/**
+* Add a sample to a low pass filter
+*
+* \param[in] p_filter Pointer to the filter
+* \param[in] sample New input sample
+* \retval filtered value, rounded to the nearest integer
+*/
+int32_t sf_UpdateLowPass(sf_lowpass_t *p_filter, int32_t sample)
+{
+    int64_t delta = 0;
+    
+    if (!p_filter->primed)
+    {
+        p_filter->state = SF_Q16_FROM_INT(sample);
+        p_filter->primed = 1u;
+    }
+    else
+    {
+        delta = ((int64_t)sample * SF_Q16_ONE) - p_filter->state;
+        p_filter->state = sf_Q16Saturate((int64_t)p_filter->state
+            + sf_RoundShiftQ16(delta * p_filter->alpha));
+    }
+    
+    return SF_Q16_TO_INT(p_filter->state);
+}
+
+/**
+* Pick the type of a selectable filter and clear its state
+*
+* \param[in] p_filter Pointer to the filter
+* \param[in] type Filter to run on each sample
+* \param[in] alpha Weight of each new sample for SF_FILTER_EMA only
+* \retval None
+*/
+void sf_InitFilter(sf_filter_t *p_filter, sf_filter_type_t type, 
+    sf_q16_t alpha)
+{
+    p_filter->type = type;
+    sf_InitLowPass(&p_filter->lowpass, alpha);
+    sf_ResetFilter(p_filter);
+}
+
+/**
+* Clear a selectable filter so it restarts from the next sample
+*
+* \param[in] p_filter Pointer to the filter
+* \retval None
+*/
+void sf_ResetFilter(sf_filter_t *p_filter)
+{
+    p_filter->count = 0u;
+    sf_ResetLowPass(&p_filter->lowpass);
+}
+
+/**
+* Add a sample to a selectable filter
+*
+* Until the history fills, the window filters work on the samples they
+* have, so the first output is the first sample.
+*
+* \param[in] p_filter Pointer to the filter
+* \param[in] sample New input sample
+* \retval filtered value
+*/
+int32_t sf_UpdateFilter(sf_filter_t *p_filter, int32_t sample)
+{
+    int32_t a = 0;
+    int32_t b = 0;
+    int32_t c = 0;
+    int32_t swap = 0;
+    int32_t sum = 0;
+    uint32_t i = 0u;
+    
+    for (i = SF_FILTER_HISTORY_LENGTH - 1u; i > 0u; i--)
+    {
+        p_filter->history[i] = p_filter->history[i - 1u];
+    }
+    p_filter->history[0] = sample;
+    if (p_filter->count < SF_FILTER_HISTORY_LENGTH)
+    {
+        p_filter->count++;
+    }
+    
+    switch (p_filter->type)
+    {
+        case SF_FILTER_MEDIAN3:
+            if (p_filter->count < 3u)
+            {
+                return sample;
+            }
+            /* order the first two, then clamp the third between them */
+            a = p_filter->history[0];
+            b = p_filter->history[1];
+            c = p_filter->history[2];
+            if (a > b)
+            {
+                swap = a;
+                a = b;
+                b = swap;
+            }
+            if (c < a)
+                return a;
+            else if (c > b)
+                return b;
+            return c;
+        
+        case SF_FILTER_EMA:
+            return sf_UpdateLowPass(&p_filter->lowpass, sample);
+        
+        case SF_FILTER_AVERAGE4:
+            for (i = 0u; i < p_filter->count; i++)
+            {
+                sum += p_filter->history[i];
+            }
+            return sum / (int32_t)p_filter->count;
+        
+        case SF_FILTER_NONE:
+        default:
+            return sample;
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/*                           Local Shared Functions                           */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                         Private (Static) Functions                         */
+/*----------------------------------------------------------------------------*/
+/**
+* Drop the extra fraction bits from a Q32.32 product, rounding to nearest
+*
+* \param[in] userValue Product of two Q16.16 numbers
+* \retval Q16.16 value (not yet saturated)
+*/
+static int64_t sf_RoundShiftQ16(int64_t userValue)
+{
+    return (userValue + (SF_Q16_ONE / 2)) >> SF_Q16_FRACTION_BITS;
+}
@@ -0,0 +1,115 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : fixedpoint_sf.h
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-04-13
+* Purpose         : shared functions layer
+*
+* This is the header file for the fixed point math, PID and filter functions.
+*
+* The AT32UC3L0256 has no FPU, so controllers use Q16.16 fixed point numbers
+* instead of floats. Only <stdint.h> is needed so this file can also be
+* compiled on a host PC to check results against a float reference.
+*
+* Shared functions are used by the mouse control interface for generic
+* functionality.
+*-----------------------------------------------------------------------------*/
+
+#ifndef FIXEDPOINT_SF_H_
+#define FIXEDPOINT_SF_H_
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+/* Q16.16 signed fixed point number */
+typedef int32_t sf_q16_t;
+
+#define SF_Q16_FRACTION_BITS    (16)
+#define SF_Q16_ONE              ((sf_q16_t)0x00010000)
+#define SF_Q16_MAX              ((sf_q16_t)0x7FFFFFFF)
+#define SF_Q16_MIN              ((sf_q16_t)0x80000000)
+
+/* conversions- use FROM_FLOAT on constants only so it folds at compile time */
+#define SF_Q16_FROM_INT(x)      ((sf_q16_t)((x) * SF_Q16_ONE))
+#define SF_Q16_FROM_FLOAT(x) \
+    ((sf_q16_t)(((x) * 65536.0f) + (((x) >= 0) ? 0.5f : -0.5f)))
+#define SF_Q16_TO_INT(x) \
+    ((int32_t)(((x) + (SF_Q16_ONE / 2)) >> SF_Q16_FRACTION_BITS))
+
+/* binary angle- full circle is 65536 counts so wraparound is free */
+typedef uint16_t sf_angle_t;
+
+#define SF_ANGLE_90_DEGREES     ((sf_angle_t)0x4000)
+#define SF_ANGLE_180_DEGREES    ((sf_angle_t)0x8000)
+#define SF_ANGLE_FROM_DEGREES(x) ((sf_angle_t)(((x) * 65536L) / 360))
+
+/* PD/PID controller w/ output saturation and integrator anti-windup */
+typedef struct
+{
+    sf_q16_t kp;            /* proportional gain */
+    sf_q16_t ki;            /* integral gain (per control tick) */
+    sf_q16_t kd;            /* derivative gain (per control tick) */
+    sf_q16_t integrator;    /* accumulated integral term */
+    int32_t prevError;      /* error from the previous update */
+    int32_t outputMin;      /* output saturation limits */
+    int32_t outputMax;
+} sf_pid_t;
+
+/* first order low pass (exponential moving average) filter */
+typedef struct
+{
+    sf_q16_t alpha;         /* weight of a new sample (0~1) */
+    sf_q16_t state;         /* filter output */
+    uint32_t primed;        /* 0 until the first sample is loaded */
+} sf_lowpass_t;
+
+/* selectable sample filter, group delay in input samples */
+typedef enum
+{
+    SF_FILTER_NONE = 0u,    /* pass through, no delay */
+    SF_FILTER_MEDIAN3,      /* median of last 3, 1 sample, drops lone spikes */
+    SF_FILTER_EMA,          /* low pass, (1 - alpha) / alpha samples */
+    SF_FILTER_AVERAGE4      /* mean of last 4, 1.5 samples */
+} sf_filter_type_t;
+
+#define SF_FILTER_HISTORY_LENGTH    (4u)
+
+typedef struct
+{
+    sf_filter_type_t type;
+    int32_t history[SF_FILTER_HISTORY_LENGTH];  /* newest sample first */
+    uint32_t count;         /* samples in history, up to its length */
+    sf_lowpass_t lowpass;   /* SF_FILTER_EMA state */
+} sf_filter_t;
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+/* None */
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+sf_q16_t sf_Q16Saturate(int64_t userValue);
+sf_q16_t sf_Q16Mul(sf_q16_t a, sf_q16_t b);
+sf_q16_t sf_Q16Div(sf_q16_t a, sf_q16_t b);
+int32_t sf_Q16MulInt(sf_q16_t gain, int32_t userValue);
+sf_q16_t sf_Q16Sin(sf_angle_t angle);
+sf_q16_t sf_Q16Cos(sf_angle_t angle);
+
+void sf_InitPid(sf_pid_t *p_pid, sf_q16_t kp, sf_q16_t ki, sf_q16_t kd,
+    int32_t outputMin, int32_t outputMax);
+void sf_SetPidGains(sf_pid_t *p_pid, sf_q16_t kp, sf_q16_t ki, sf_q16_t kd);
+void sf_ResetPid(sf_pid_t *p_pid);
+int32_t sf_UpdatePid(sf_pid_t *p_pid, int32_t error);
+
+void sf_InitLowPass(sf_lowpass_t *p_filter, sf_q16_t alpha);
+void sf_ResetLowPass(sf_lowpass_t *p_filter);
+int32_t sf_UpdateLowPass(sf_lowpass_t *p_filter, int32_t sample);
+
+void sf_InitFilter(sf_filter_t *p_filter, sf_filter_type_t type, 
+    sf_q16_t alpha);
+void sf_ResetFilter(sf_filter_t *p_filter);
+int32_t sf_UpdateFilter(sf_filter_t *p_filter, int32_t sample);
+
+#endif /* FIXEDPOINT_SF_H_ */
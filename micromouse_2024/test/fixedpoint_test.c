@@ -0,0 +1,321 @@
+/*-------------------------------- FILE INFO -----------------------------------
+* Filename        : fixedpoint_test.c
+* Author          : Team Kirbo
+* Revision        : 1.0
+* Updated         : 2024-04-13
+* Purpose         : host test
+*
+* This is the host PC test for the fixed point math, PID and filter
+* functions. Each result is checked against the same math done w/ doubles.
+* Not part of the firmware build- from micromouse_2024/ run:
+*
+*     gcc -std=c99 -Wall -Isrc -o fixedpoint_test test/fixedpoint_test.c \
+*         src/shared_functions/fixedpoint_sf.c -lm && ./fixedpoint_test
+*
+* Exits w/ 0 when every check passes.
+*-----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <math.h>
+#include "shared_functions/fixedpoint_sf.h"
+
+/*----------------------------------------------------------------------------*/
+/*                                Definitions                                 */
+/*----------------------------------------------------------------------------*/
+#define TEST_PI                 (3.14159265358979323846)
+
+/* largest allowed difference from the float reference */
+#define TEST_INT_TOLERANCE      (1.0)       /* integer outputs, rounding */
+#define TEST_TRIG_TOLERANCE     (0.0005)    /* interpolated sine table */
+
+#define TEST_PID_STEPS          (200)
+#define TEST_FILTER_STEPS       (200)
+
+/*----------------------------------------------------------------------------*/
+/*                              Global Variables                              */
+/*----------------------------------------------------------------------------*/
+static uint32_t testFailures = 0u;
+static uint32_t testChecks = 0u;
+
+/*----------------------------------------------------------------------------*/
+/*                    Private (Static) Function Prototype                     */
+/*----------------------------------------------------------------------------*/
+static void test_Check(const char *p_name, int32_t step, double actual,
+    double expected, double tolerance);
+static double test_Q16ToDouble(sf_q16_t value);
+static int32_t test_Input(int32_t step);
+static void test_Saturation(void);
+static void test_Trig(void);
+static void test_Pid(double kp, double ki, double kd, int32_t outputLimit);
+static void test_Filter(sf_filter_type_t type, double alpha);
+
+/*----------------------------------------------------------------------------*/
+/*                       Public (Exportable) Functions                        */
+/*----------------------------------------------------------------------------*/
+/**
+* Run every check and report the result
+*
+* \param None
+* \retval 0 All checks passed
+* \retval 1 At least one check failed
+*/
+int main(void)
+{
+    test_Saturation();
+    test_Trig();
+    
+    /* PD as used by the move engine, PI/PID w/ and w/o saturation */
+    test_Pid(2.0, 0.0, 0.2, 255);
+    test_Pid(0.1, 0.0, 0.01, 255);
+    test_Pid(1.5, 0.05, 0.5, 255);
+    test_Pid(8.0, 0.5, 1.0, 60);
+    
+    test_Filter(SF_FILTER_NONE, 0.5);
+    test_Filter(SF_FILTER_MEDIAN3, 0.5);
+    test_Filter(SF_FILTER_EMA, 0.5);
+    test_Filter(SF_FILTER_EMA, 0.125);
+    test_Filter(SF_FILTER_AVERAGE4, 0.5);
+    
+    printf("%u checks, %u failed\n", testChecks, testFailures);
+    
+    return (testFailures == 0u) ? 0 : 1;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                         Private (Static) Functions                         */
+/*----------------------------------------------------------------------------*/
+/**
+* Compare one result w/ its float reference and report a mismatch
+*
+* \param[in] p_name What was checked
+* \param[in] step Sample number, -1 for single checks
+* \param[in] actual Fixed point result
+* \param[in] expected Float reference result
+* \param[in] tolerance Largest allowed difference
+* \retval None
+*/
+static void test_Check(const char *p_name, int32_t step, double actual,
+    double expected, double tolerance)
+{
+    testChecks++;
+    
+    if (fabs(actual - expected) > tolerance)
+    {
+        testFailures++;
+        printf("FAIL %s step %d: got %f, expected %f\n", p_name, step,
+            actual, expected);
+    }
+}
+
+/**
+* Convert a Q16.16 number to a double
+*
+* \param[in] value Q16.16 number
+* \retval value as a double
+*/
+static double test_Q16ToDouble(sf_q16_t value)
+{
+    return (double)value / 65536.0;
+}
+
+/**
+* Get a test input- a step, a ramp and a lone spike on top of a square wave
+*
+* \param[in] step Sample number
+* \retval input sample
+*/
+static int32_t test_Input(int32_t step)
+{
+    int32_t sample = ((step / 25) % 2) ? 300 : -120;
+    
+    sample += (step % 50) * 3;
+    if ((step % 37) == 0)
+    {
+        sample += 900;
+    }
+    
+    return sample;
+}
+
+/**
+* Check Q16.16 saturation, multiply and divide at and past the range ends
+*
+* \param None
+* \retval None
+*/
+static void test_Saturation(void)
+{
+    test_Check("saturate max", -1, (double)sf_Q16Saturate(
+        (int64_t)SF_Q16_MAX + 1000), (double)SF_Q16_MAX, 0.0);
+    test_Check("saturate min", -1, (double)sf_Q16Saturate(
+        (int64_t)SF_Q16_MIN - 1000), (double)SF_Q16_MIN, 0.0);
+    test_Check("saturate pass", -1, (double)sf_Q16Saturate(-12345),
+        -12345.0, 0.0);
+    
+    test_Check("mul", -1, test_Q16ToDouble(sf_Q16Mul(
+        SF_Q16_FROM_FLOAT(1.5f), SF_Q16_FROM_FLOAT(-2.25f))), -3.375,
+        1.0 / 65536.0);
+    test_Check("mul overflow", -1, (double)sf_Q16Mul(
+        SF_Q16_FROM_INT(30000), SF_Q16_FROM_INT(30000)),
+        (double)SF_Q16_MAX, 0.0);
+    test_Check("mul underflow", -1, (double)sf_Q16Mul(
+        SF_Q16_FROM_INT(-30000), SF_Q16_FROM_INT(30000)),
+        (double)SF_Q16_MIN, 0.0);
+    
+    test_Check("div", -1, test_Q16ToDouble(sf_Q16Div(
+        SF_Q16_FROM_INT(7), SF_Q16_FROM_INT(-4))), -1.75, 1.0 / 65536.0);
+    test_Check("div by zero", -1, (double)sf_Q16Div(SF_Q16_FROM_INT(-1), 0),
+        (double)SF_Q16_MIN, 0.0);
+    
+    test_Check("mul int", -1, (double)sf_Q16MulInt(SF_Q16_FROM_FLOAT(0.3f),
+        -1001), -300.3, 0.5 + (1001.0 / 65536.0));
+}
+
+/**
+* Check the table sine and cosine around the whole circle
+*
+* \param None
+* \retval None
+*/
+static void test_Trig(void)
+{
+    int32_t angle = 0;
+    double radians = 0.0;
+    
+    for (angle = 0; angle < 65536; angle += 97)
+    {
+        radians = ((double)angle * 2.0 * TEST_PI) / 65536.0;
+        test_Check("sin", angle, test_Q16ToDouble(sf_Q16Sin(
+            (sf_angle_t)angle)), sin(radians), TEST_TRIG_TOLERANCE);
+        test_Check("cos", angle, test_Q16ToDouble(sf_Q16Cos(
+            (sf_angle_t)angle)), cos(radians), TEST_TRIG_TOLERANCE);
+    }
+}
+
+/**
+* Run the fixed point PID and a float PID side by side on the test input
+*
+* The float PID clamps its integrator to the output limits the same way,
+* so both saturate and unwind together.
+*
+* \param[in] kp Proportional gain
+* \param[in] ki Integral gain per update
+* \param[in] kd Derivative gain per update
+* \param[in] outputLimit Output saturates at +/- this
+* \retval None
+*/
+static void test_Pid(double kp, double ki, double kd, int32_t outputLimit)
+{
+    sf_pid_t pid;
+    double integrator = 0.0;
+    double prevError = 0.0;
+    double expected = 0.0;
+    int32_t error = 0;
+    int32_t step = 0;
+    
+    sf_InitPid(&pid, SF_Q16_FROM_FLOAT(kp), SF_Q16_FROM_FLOAT(ki),
+        SF_Q16_FROM_FLOAT(kd), -outputLimit, outputLimit);
+    
+    /* compare against the gains actually stored, not their decimal value */
+    kp = test_Q16ToDouble(pid.kp);
+    ki = test_Q16ToDouble(pid.ki);
+    kd = test_Q16ToDouble(pid.kd);
+    
+    for (step = 0; step < TEST_PID_STEPS; step++)
+    {
+        error = test_Input(step) / 4;
+    
+        integrator += ki * error;
+        if (integrator > outputLimit)
+            integrator = outputLimit;
+        else if (integrator < -outputLimit)
+            integrator = -outputLimit;
+    
+        expected = (kp * error) + (kd * (error - prevError)) + integrator;
+        prevError = error;
+        if (expected > outputLimit)
+            expected = outputLimit;
+        else if (expected < -outputLimit)
+            expected = -outputLimit;
+    
+        test_Check("pid", step, (double)sf_UpdatePid(&pid, error), expected,
+            TEST_INT_TOLERANCE);
+    }
+}
+
+/**
+* Run a selectable filter and its float reference side by side
+*
+* \param[in] type Filter to check
+* \param[in] alpha Weight of each new sample for SF_FILTER_EMA
+* \retval None
+*/
+static void test_Filter(sf_filter_type_t type, double alpha)
+{
+    sf_filter_t filter;
+    double history[SF_FILTER_HISTORY_LENGTH] = {0.0};
+    double expected = 0.0;
+    double ema = 0.0;
+    double a = 0.0;
+    double b = 0.0;
+    double c = 0.0;
+    int32_t sample = 0;
+    int32_t step = 0;
+    uint32_t count = 0u;
+    uint32_t i = 0u;
+    
+    sf_InitFilter(&filter, type, SF_Q16_FROM_FLOAT(alpha));
+    alpha = test_Q16ToDouble(filter.lowpass.alpha);
+    
+    for (step = 0; step < TEST_FILTER_STEPS; step++)
+    {
+        sample = test_Input(step);
+    
+        for (i = SF_FILTER_HISTORY_LENGTH - 1u; i > 0u; i--)
+        {
+            history[i] = history[i - 1u];
+        }
+        history[0] = sample;
+        if (count < SF_FILTER_HISTORY_LENGTH)
+        {
+            count++;
+        }
+        ema = (step == 0) ? sample : ema + (alpha * (sample - ema));
+    
+        switch (type)
+        {
+            case SF_FILTER_MEDIAN3:
+                a = history[0];
+                b = history[1];
+                c = history[2];
+                expected = (count < 3u) ? sample :
+                    fmax(fmin(a, b), fmin(fmax(a, b), c));
+                break;
+    
+            case SF_FILTER_EMA:
+                expected = ema;
+                break;
+    
+            case SF_FILTER_AVERAGE4:
+                expected = 0.0;
+                for (i = 0u; i < count; i++)
+                {
+                    expected += history[i];
+                }
+                expected = trunc(expected / count);
+                break;
+    
+            case SF_FILTER_NONE:
+            default:
+                expected = sample;
+                break;
+        }
+    
+        test_Check("filter", step, (double)sf_UpdateFilter(&filter, sample),
+            expected, (type == SF_FILTER_EMA) ? TEST_INT_TOLERANCE : 0.0);
+    }
+}